@@ -0,0 +1,299 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ApplyPipeline.h"
+
+#include "ISettingsPage.h"
+
+#include <QRunnable>
+#include <QThreadPool>
+
+constexpr auto PageProgressMaximum = 100;
+
+//! @cond
+
+class Nedrysoft::SettingsDialog::ApplyPipeline::Task :
+        public QRunnable {
+
+    public:
+        Task(ApplyPipeline *pipeline, ISettingsPage *page, Operation operation) :
+                m_pipeline(pipeline),
+                m_page(page),
+                m_operation(operation) {
+
+        }
+
+        auto run() -> void override {
+            auto pipeline = m_pipeline;
+            auto isSuccessful = (m_operation==Operation::Prepare) ?
+                    m_page->prepareSettings() :
+                    m_page->applyCapturedSettings();
+
+            QMetaObject::invokeMethod(m_pipeline, [pipeline, isSuccessful]() {
+                pipeline->stepFinished(isSuccessful);
+            }, Qt::QueuedConnection);
+        }
+
+    private:
+        ApplyPipeline *m_pipeline;
+        ISettingsPage *m_page;
+        Operation m_operation;
+};
+
+//! @endcond
+
+Nedrysoft::SettingsDialog::ApplyPipeline::ApplyPipeline(QObject *parent) :
+        QObject(parent),
+        m_failedPage(nullptr),
+        m_index(0),
+        m_pageProgress(0),
+        m_isRunning(false),
+        m_isCancelled(false) {
+
+    // pages are applied strictly in order, so a single worker thread is used
+
+    m_threadPool = new QThreadPool(this);
+
+    m_threadPool->setMaxThreadCount(1);
+}
+
+Nedrysoft::SettingsDialog::ApplyPipeline::~ApplyPipeline() {
+    m_threadPool->waitForDone();
+
+    discard();
+}
+
+auto Nedrysoft::SettingsDialog::ApplyPipeline::start(const QList<ISettingsPage *> &pages) -> void {
+    if (m_isRunning) {
+        return;
+    }
+
+    // the steps are ordered so that nothing is committed until every transactional page has been prepared, pages
+    // kept from an earlier run that failed are skipped.
+
+    QList<QPair<Operation, ISettingsPage *> > prepareSteps, commitSteps, applySteps;
+
+    for (auto page : pages) {
+        if (m_appliedPages.contains(page)) {
+            continue;
+        }
+
+        if (page->isTransactional()) {
+            if (!m_preparedPages.contains(page)) {
+                prepareSteps.append(qMakePair(Operation::Prepare, page));
+            }
+
+            commitSteps.append(qMakePair(Operation::Commit, page));
+        } else {
+            applySteps.append(qMakePair(Operation::Apply, page));
+        }
+    }
+
+    m_steps = prepareSteps+commitSteps+applySteps;
+    m_failedPage = nullptr;
+    m_index = 0;
+    m_pageProgress = 0;
+    m_isRunning = true;
+    m_isCancelled = false;
+
+    runNextStep();
+}
+
+auto Nedrysoft::SettingsDialog::ApplyPipeline::cancel() -> void {
+    if (m_isRunning) {
+        m_isCancelled = true;
+    }
+}
+
+auto Nedrysoft::SettingsDialog::ApplyPipeline::invalidate(ISettingsPage *page) -> void {
+    // a page that changes during a run may be about to be committed, so it is invalidated once the run stops
+
+    if (m_isRunning) {
+        m_invalidatedPages.insert(page);
+
+        return;
+    }
+
+    if (m_preparedPages.remove(page)) {
+        page->rollbackSettings();
+    }
+
+    m_appliedPages.remove(page);
+}
+
+auto Nedrysoft::SettingsDialog::ApplyPipeline::discard() -> void {
+    for (auto page : m_preparedPages) {
+        page->rollbackSettings();
+    }
+
+    m_preparedPages.clear();
+    m_appliedPages.clear();
+}
+
+auto Nedrysoft::SettingsDialog::ApplyPipeline::isRunning() -> bool {
+    return m_isRunning;
+}
+
+auto Nedrysoft::SettingsDialog::ApplyPipeline::failedPage() -> Nedrysoft::SettingsDialog::ISettingsPage * {
+    return m_failedPage;
+}
+
+auto Nedrysoft::SettingsDialog::ApplyPipeline::runNextStep() -> void {
+    if (m_index>=m_steps.count()) {
+        m_preparedPages.clear();
+        m_appliedPages.clear();
+
+        finish(true);
+
+        return;
+    }
+
+    if (m_isCancelled) {
+        finish(false);
+
+        return;
+    }
+
+    auto operation = m_steps.at(m_index).first;
+    auto page = m_steps.at(m_index).second;
+
+    if (operation==Operation::Commit) {
+        commitPages();
+
+        return;
+    }
+
+    m_pageProgress = 0;
+
+    updateProgress();
+
+    m_progressConnection = connect(page, &ISettingsPage::applyProgress, this, [=](int percent) {
+        m_pageProgress = qBound(0, percent, PageProgressMaximum);
+
+        updateProgress();
+    });
+
+    if (page->canApplyInBackground()) {
+        page->captureSettings();
+
+        m_threadPool->start(new Task(this, page, operation));
+
+        return;
+    }
+
+    auto isSuccessful = true;
+
+    if (operation==Operation::Prepare) {
+        isSuccessful = page->prepareSettings();
+    } else {
+        page->acceptSettings();
+    }
+
+    // the result is delivered through the event loop so that the progress is painted between pages
+
+    QMetaObject::invokeMethod(this, [=]() {
+        stepFinished(isSuccessful);
+    }, Qt::QueuedConnection);
+}
+
+auto Nedrysoft::SettingsDialog::ApplyPipeline::commitPages() -> void {
+    // this is the commit point, every prepared page is committed without returning to the event loop so that the
+    // commit cannot be cancelled part way through.
+
+    auto firstCommit = m_index;
+
+    while ((m_index<m_steps.count()) && (m_steps.at(m_index).first==Operation::Commit)) {
+        auto page = m_steps.at(m_index).second;
+
+        if (!page->commitSettings()) {
+            m_failedPage = page;
+
+            // the pages committed before the failure are reverted in reverse order so that the commit is all or
+            // nothing, a page that cannot revert stays committed and is not applied again by a retry.
+
+            for (auto index=m_index-1;index>=firstCommit;index--) {
+                auto committedPage = m_steps.at(index).second;
+
+                if (committedPage->revertSettings()) {
+                    m_appliedPages.remove(committedPage);
+                }
+            }
+
+            finish(false);
+
+            return;
+        }
+
+        m_preparedPages.remove(page);
+        m_appliedPages.insert(page);
+
+        m_index++;
+    }
+
+    updateProgress();
+
+    runNextStep();
+}
+
+auto Nedrysoft::SettingsDialog::ApplyPipeline::stepFinished(bool isSuccessful) -> void {
+    disconnect(m_progressConnection);
+
+    auto operation = m_steps.at(m_index).first;
+    auto page = m_steps.at(m_index).second;
+
+    if (!isSuccessful) {
+        m_failedPage = page;
+
+        finish(false);
+
+        return;
+    }
+
+    if (operation==Operation::Prepare) {
+        m_preparedPages.insert(page);
+    } else {
+        m_appliedPages.insert(page);
+    }
+
+    m_index++;
+    m_pageProgress = 0;
+
+    runNextStep();
+}
+
+auto Nedrysoft::SettingsDialog::ApplyPipeline::finish(bool isApplied) -> void {
+    m_steps.clear();
+    m_isRunning = false;
+
+    for (auto page : m_invalidatedPages) {
+        invalidate(page);
+    }
+
+    m_invalidatedPages.clear();
+
+    Q_EMIT finished(isApplied);
+}
+
+auto Nedrysoft::SettingsDialog::ApplyPipeline::updateProgress() -> void {
+    Q_EMIT progressChanged(
+            (m_index*PageProgressMaximum)+m_pageProgress,
+            static_cast<int>(m_steps.count())*PageProgressMaximum);
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_APPLYPIPELINE_H
+#define NEDRYSOFT_APPLYPIPELINE_H
+
+#include <QList>
+#include <QMetaObject>
+#include <QObject>
+#include <QPair>
+#include <QSet>
+
+class QThreadPool;
+
+namespace Nedrysoft { namespace SettingsDialog {
+    class ISettingsPage;
+
+    /**
+     * @brief       The ApplyPipeline class applies the settings of a list of pages without blocking the GUI.
+     *
+     * @details     The pages are applied one at a time in order.  Pages that can apply in the background have
+     *              their settings captured on the GUI thread and applied on a worker thread, other pages are
+     *              applied on the GUI thread with the event loop running between pages.  A cancellation takes
+     *              effect before the next page starts applying, a page that has started is always allowed to
+     *              finish.
+     *
+     *              Transactional pages are handled in two phases, every transactional page is prepared first and
+     *              only once all have been prepared are they committed together, the remaining pages are then
+     *              applied.  The commit point cannot be cancelled, if a page fails to commit then the pages that
+     *              were committed before it are reverted.  Pages that were prepared or applied by a run
+     *              that failed or was cancelled are remembered, so retrying only repeats the work that did not
+     *              succeed unless a page has been invalidated since.
+     */
+    class ApplyPipeline :
+            public QObject {
+
+        private:
+            Q_OBJECT
+
+        public:
+            /**
+             * @brief       Constructs a new ApplyPipeline.
+             *
+             * @param[in]   parent the owner of the pipeline.
+             */
+            explicit ApplyPipeline(QObject *parent=nullptr);
+
+            /**
+             * @brief       Destroys the ApplyPipeline, waiting for a page that is being applied to finish.
+             */
+            ~ApplyPipeline();
+
+            /**
+             * @brief       Starts applying the settings of a list of pages.
+             *
+             * @note        The pages should already have been validated.
+             *
+             * @param[in]   pages the pages to apply.
+             */
+            auto start(const QList<ISettingsPage *> &pages) -> void;
+
+            /**
+             * @brief       Cancels the pipeline before the next page is applied.
+             */
+            auto cancel() -> void;
+
+            /**
+             * @brief       Discards the work kept from a failed or cancelled run for a page.
+             *
+             * @details     This should be called when the settings of the page change, a prepared page is rolled
+             *              back so that it is prepared again with the new settings.
+             *
+             * @param[in]   page the page.
+             */
+            auto invalidate(ISettingsPage *page) -> void;
+
+            /**
+             * @brief       Discards all work kept from a failed or cancelled run, rolling back prepared pages.
+             */
+            auto discard() -> void;
+
+            /**
+             * @brief       Returns whether the pipeline is running.
+             *
+             * @returns     true if running; otherwise false.
+             */
+            auto isRunning() -> bool;
+
+            /**
+             * @brief       Returns the page that failed to apply.
+             *
+             * @returns     the page if the last run failed; otherwise nullptr.
+             */
+            auto failedPage() -> ISettingsPage *;
+
+            /**
+             * @brief       Emitted when the aggregated progress changes.
+             *
+             * @param[in]   value the progress.
+             * @param[in]   maximum the value at which all pages have been applied.
+             */
+            Q_SIGNAL void progressChanged(int value, int maximum);
+
+            /**
+             * @brief       Emitted when the pipeline stops.
+             *
+             * @param[in]   isApplied true if every page was applied; false if cancelled or a page failed.
+             */
+            Q_SIGNAL void finished(bool isApplied);
+
+        private:
+            /**
+             * @brief       The operations that the pipeline performs on a page.
+             */
+            enum class Operation {
+                Prepare,
+                Commit,
+                Apply
+            };
+
+            /**
+             * @brief       Starts the next step, or finishes if there are no more steps.
+             */
+            auto runNextStep() -> void;
+
+            /**
+             * @brief       Commits every prepared page, reverting the committed pages if a commit fails.
+             */
+            auto commitPages() -> void;
+
+            /**
+             * @brief       Called when the current step has finished.
+             *
+             * @param[in]   isSuccessful true if the step succeeded; otherwise false.
+             */
+            auto stepFinished(bool isSuccessful) -> void;
+
+            /**
+             * @brief       Stops the pipeline.
+             *
+             * @param[in]   isApplied true if every page was applied; otherwise false.
+             */
+            auto finish(bool isApplied) -> void;
+
+            /**
+             * @brief       Emits the aggregated progress.
+             */
+            auto updateProgress() -> void;
+
+        private:
+            //! @cond
+
+            class Task;
+
+            QThreadPool *m_threadPool;
+            QList<QPair<Operation, ISettingsPage *> > m_steps;
+            QSet<ISettingsPage *> m_preparedPages;
+            QSet<ISettingsPage *> m_appliedPages;
+            QSet<ISettingsPage *> m_invalidatedPages;
+            QMetaObject::Connection m_progressConnection;
+            ISettingsPage *m_failedPage;
+            int m_index;
+            int m_pageProgress;
+            bool m_isRunning;
+            bool m_isCancelled;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_APPLYPIPELINE_H
@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ConstraintRegistry.h"
+
+#include "SettingsStore.h"
+
+#include <QSet>
+
+Nedrysoft::SettingsDialog::ConstraintRegistry::ConstraintRegistry(QObject *parent) :
+        QObject(parent),
+        m_isSorted(true),
+        m_isDirty(false) {
+
+}
+
+auto Nedrysoft::SettingsDialog::ConstraintRegistry::addConstraint(
+        ISettingsPage *page,
+        const QString &key,
+        const QStringList &dependencies,
+        Validator validator) -> void {
+
+    Constraint constraint;
+
+    constraint.m_page = page;
+    constraint.m_key = key;
+    constraint.m_dependencies = dependencies;
+    constraint.m_validator = validator;
+    constraint.m_isValid = true;
+    constraint.m_isDirty = true;
+
+    m_constraints.append(constraint);
+
+    m_isSorted = false;
+    m_isDirty = true;
+}
+
+auto Nedrysoft::SettingsDialog::ConstraintRegistry::setValue(const QString &key, const QVariant &value) -> void {
+    auto currentValue = m_values.constFind(key);
+
+    if ((currentValue!=m_values.constEnd()) && (currentValue.value()==value)) {
+        return;
+    }
+
+    m_values[key] = value;
+
+    invalidate(key);
+}
+
+auto Nedrysoft::SettingsDialog::ConstraintRegistry::value(const QString &key) -> QVariant {
+    auto currentValue = m_values.constFind(key);
+
+    if (currentValue!=m_values.constEnd()) {
+        return currentValue.value();
+    }
+
+    return SettingsStore::getInstance()->value(key);
+}
+
+auto Nedrysoft::SettingsDialog::ConstraintRegistry::isValid(ISettingsPage *page) -> bool {
+    evaluate();
+
+    for (auto &constraint : m_constraints) {
+        if ((constraint.m_page==page) && !constraint.m_isValid) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+auto Nedrysoft::SettingsDialog::ConstraintRegistry::firstInvalidPage() -> Nedrysoft::SettingsDialog::ISettingsPage * {
+    evaluate();
+
+    for (auto &constraint : m_constraints) {
+        if (!constraint.m_isValid) {
+            return constraint.m_page;
+        }
+    }
+
+    return nullptr;
+}
+
+auto Nedrysoft::SettingsDialog::ConstraintRegistry::sort() -> void {
+    QMultiHash<QString, int> validators;
+
+    for (auto index=0;index<m_constraints.count();index++) {
+        validators.insert(m_constraints.at(index).m_key, index);
+    }
+
+    // a constraint depends on every other constraint that validates one of the keys that it reads
+
+    QVector<int> dependencyCount(m_constraints.count(), 0);
+    QVector<QList<int>> dependents(m_constraints.count());
+
+    for (auto index=0;index<m_constraints.count();index++) {
+        for (auto &dependency : m_constraints.at(index).m_dependencies) {
+            for (auto validator : validators.values(dependency)) {
+                if (validator!=index) {
+                    dependents[validator].append(index);
+                    dependencyCount[index]++;
+                }
+            }
+        }
+    }
+
+    QList<int> readyConstraints;
+    QVector<int> order;
+
+    for (auto index=0;index<m_constraints.count();index++) {
+        if (!dependencyCount.at(index)) {
+            readyConstraints.append(index);
+        }
+    }
+
+    while (!readyConstraints.isEmpty()) {
+        auto index = readyConstraints.takeFirst();
+
+        order.append(index);
+
+        for (auto dependent : dependents.at(index)) {
+            if (!--dependencyCount[dependent]) {
+                readyConstraints.append(dependent);
+            }
+        }
+    }
+
+    for (auto index=0;index<m_constraints.count();index++) {
+        if (dependencyCount.at(index)) {
+            order.append(index);
+        }
+    }
+
+    QVector<Constraint> constraints;
+
+    constraints.reserve(m_constraints.count());
+
+    for (auto index : order) {
+        constraints.append(m_constraints.at(index));
+
+        constraints.last().m_isDirty = true;
+    }
+
+    m_constraints = constraints;
+
+    m_readers.clear();
+    m_validators.clear();
+
+    for (auto index=0;index<m_constraints.count();index++) {
+        auto &constraint = m_constraints.at(index);
+
+        m_validators.insert(constraint.m_key, index);
+        m_readers.insert(constraint.m_key, index);
+
+        for (auto &dependency : constraint.m_dependencies) {
+            m_readers.insert(dependency, index);
+        }
+    }
+
+    m_isSorted = true;
+    m_isDirty = !m_constraints.isEmpty();
+}
+
+auto Nedrysoft::SettingsDialog::ConstraintRegistry::invalidate(const QString &key) -> void {
+    if (!m_isSorted) {
+        sort();
+    }
+
+    // the change is propagated through the keys validated by the affected constraints, as the constraints that
+    // depend on those keys may now pass or fail.
+
+    QSet<int> affectedConstraints;
+    QSet<ISettingsPage *> affectedPages;
+    QStringList changedKeys = QStringList() << key;
+
+    while (!changedKeys.isEmpty()) {
+        auto changedKey = changedKeys.takeFirst();
+
+        for (auto index : m_readers.values(changedKey)) {
+            if (affectedConstraints.contains(index)) {
+                continue;
+            }
+
+            auto &constraint = m_constraints[index];
+
+            affectedConstraints.insert(index);
+
+            constraint.m_isDirty = true;
+
+            changedKeys.append(constraint.m_key);
+
+            affectedPages.insert(constraint.m_page);
+        }
+    }
+
+    if (affectedConstraints.isEmpty()) {
+        return;
+    }
+
+    m_isDirty = true;
+
+    for (auto page : affectedPages) {
+        Q_EMIT pageInvalidated(page);
+    }
+}
+
+auto Nedrysoft::SettingsDialog::ConstraintRegistry::evaluate() -> void {
+    if (!m_isSorted) {
+        sort();
+    }
+
+    if (!m_isDirty) {
+        return;
+    }
+
+    for (auto &constraint : m_constraints) {
+        if (!constraint.m_isDirty) {
+            continue;
+        }
+
+        constraint.m_isDirty = false;
+        constraint.m_isValid = true;
+
+        QVariantMap values;
+
+        values[constraint.m_key] = value(constraint.m_key);
+
+        for (auto &dependency : constraint.m_dependencies) {
+            if ((dependency!=constraint.m_key) && !isKeyValid(dependency)) {
+                constraint.m_isValid = false;
+
+                break;
+            }
+
+            values[dependency] = value(dependency);
+        }
+
+        if (constraint.m_isValid) {
+            constraint.m_isValid = constraint.m_validator(values);
+        }
+    }
+
+    m_isDirty = false;
+}
+
+auto Nedrysoft::SettingsDialog::ConstraintRegistry::isKeyValid(const QString &key) -> bool {
+    for (auto index : m_validators.values(key)) {
+        if (!m_constraints.at(index).m_isValid) {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_CONSTRAINTREGISTRY_H
+#define NEDRYSOFT_CONSTRAINTREGISTRY_H
+
+#include "SettingsDialogSpec.h"
+
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+#include <functional>
+
+namespace Nedrysoft { namespace SettingsDialog {
+    class ISettingsPage;
+
+    /**
+     * @brief       The ConstraintRegistry class holds the constraints between settings on different pages.
+     *
+     * @details     A constraint validates the value of a key and may depend on the values of other keys, which
+     *              may belong to other pages.  Pages register their constraints and report the values that are
+     *              being edited, the value of a key that has not been edited is read from the SettingsStore.
+     *
+     *              When a value changes only the constraints that read the key, and the constraints that depend
+     *              on the keys validated by those, are re-evaluated.  Constraints are evaluated in dependency
+     *              order and a constraint fails without being evaluated if a key that it depends on is not valid.
+     */
+    class SETTINGS_DIALOG_DLLSPEC ConstraintRegistry :
+            public QObject {
+
+        private:
+            Q_OBJECT
+
+        public:
+            /**
+             * @brief       The function that evaluates a constraint.
+             *
+             * @details     The function is passed the values of the validated key and of its dependencies.
+             */
+            using Validator = std::function<bool(const QVariantMap &values)>;
+
+            /**
+             * @brief       Constructs a new ConstraintRegistry.
+             *
+             * @param[in]   parent the owner of the registry.
+             */
+            explicit ConstraintRegistry(QObject *parent=nullptr);
+
+            /**
+             * @brief       Adds a constraint.
+             *
+             * @param[in]   page the page that the constraint belongs to, the page is not valid while the constraint
+             *              fails.
+             * @param[in]   key the key that is validated.
+             * @param[in]   dependencies the other keys that the constraint reads.
+             * @param[in]   validator the function that evaluates the constraint.
+             */
+            auto addConstraint(
+                    ISettingsPage *page,
+                    const QString &key,
+                    const QStringList &dependencies,
+                    Validator validator) -> void;
+
+            /**
+             * @brief       Sets the edited value of a key.
+             *
+             * @param[in]   key the key.
+             * @param[in]   value the new value.
+             */
+            auto setValue(const QString &key, const QVariant &value) -> void;
+
+            /**
+             * @brief       Returns the current value of a key.
+             *
+             * @param[in]   key the key.
+             *
+             * @returns     the edited value if there is one; otherwise the stored value.
+             */
+            auto value(const QString &key) -> QVariant;
+
+            /**
+             * @brief       Returns whether every constraint of a page is satisfied.
+             *
+             * @param[in]   page the page.
+             *
+             * @returns     true if the constraints are satisfied; otherwise false.
+             */
+            auto isValid(ISettingsPage *page) -> bool;
+
+            /**
+             * @brief       Returns the first page that has a constraint that is not satisfied.
+             *
+             * @details     Every page that registered constraints is checked, whether or not it has been shown.
+             *
+             * @returns     the page if any constraint is not satisfied; otherwise nullptr.
+             */
+            auto firstInvalidPage() -> ISettingsPage *;
+
+            /**
+             * @brief       Emitted when a value that a constraint of a page reads has changed.
+             *
+             * @param[in]   page the page whose constraints need to be re-evaluated.
+             */
+            Q_SIGNAL void pageInvalidated(Nedrysoft::SettingsDialog::ISettingsPage *page);
+
+        private:
+            /**
+             * @brief       Sorts the constraints so that each constraint follows the constraints it depends on.
+             *
+             * @details     Constraints that form a cycle cannot be ordered and are placed at the end.
+             */
+            auto sort() -> void;
+
+            /**
+             * @brief       Marks the constraints affected by a change to a key for re-evaluation.
+             *
+             * @param[in]   key the key that changed.
+             */
+            auto invalidate(const QString &key) -> void;
+
+            /**
+             * @brief       Evaluates the constraints that have been marked for re-evaluation.
+             */
+            auto evaluate() -> void;
+
+            /**
+             * @brief       Returns whether every constraint on a key is satisfied.
+             *
+             * @param[in]   key the key.
+             *
+             * @returns     true if the key is valid; otherwise false.
+             */
+            auto isKeyValid(const QString &key) -> bool;
+
+        private:
+            //! @cond
+
+            struct Constraint {
+                ISettingsPage *m_page;
+                QString m_key;
+                QStringList m_dependencies;
+                Validator m_validator;
+                bool m_isValid;
+                bool m_isDirty;
+            };
+
+            QVector<Constraint> m_constraints;
+            QMultiHash<QString, int> m_readers;
+            QMultiHash<QString, int> m_validators;
+            QVariantMap m_values;
+            bool m_isSorted;
+            bool m_isDirty;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_CONSTRAINTREGISTRY_H
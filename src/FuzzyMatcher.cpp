@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FuzzyMatcher.h"
+
+#include <QtAlgorithms>
+
+#if defined(__AVX2__)
+#define NEDRYSOFT_FUZZYMATCHER_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP>=2))
+#define NEDRYSOFT_FUZZYMATCHER_SSE2
+#include <emmintrin.h>
+#endif
+
+constexpr auto MatchScore = 16;
+constexpr auto ConsecutiveBonus = 8;
+constexpr auto WordStartBonus = 8;
+constexpr auto GapStartPenalty = 3;
+constexpr auto GapExtensionPenalty = 1;
+constexpr auto MaximumGapPenalty = 12;
+constexpr int FieldWeights[] = {4, 3, 2, 1};
+
+Nedrysoft::SettingsDialog::FuzzyMatcher::FuzzyMatcher(const QString &pattern) {
+    m_pattern = normalise(pattern);
+
+    m_pattern.remove(QChar(' '));
+}
+
+auto Nedrysoft::SettingsDialog::FuzzyMatcher::isEmpty() -> bool {
+    return m_pattern.isEmpty();
+}
+
+auto Nedrysoft::SettingsDialog::FuzzyMatcher::score(const QString &text) -> int {
+    auto patternData = reinterpret_cast<const ushort *>(m_pattern.utf16());
+    auto patternLength = static_cast<int>(m_pattern.length());
+    auto textData = reinterpret_cast<const ushort *>(text.utf16());
+    auto textLength = static_cast<int>(text.length());
+
+    if (!patternLength || (patternLength>textLength)) {
+        return -1;
+    }
+
+    // forward pass, find the end of the first occurrence of the subsequence
+
+    auto position = 0;
+
+    for (auto patternIndex=0;patternIndex<patternLength;patternIndex++) {
+        position = findCharacter(textData, position, textLength, patternData[patternIndex]);
+
+        if (position==-1) {
+            return -1;
+        }
+
+        position++;
+    }
+
+    // backward pass, find the latest start of the subsequence so that the match is as tight as possible
+
+    auto start = position-1;
+
+    for (auto patternIndex=patternLength-1;patternIndex>=0;start--) {
+        if (textData[start]==patternData[patternIndex]) {
+            if (!patternIndex) {
+                break;
+            }
+
+            patternIndex--;
+        }
+    }
+
+    // score the match within the window
+
+    auto score = 0;
+    auto previousMatch = -1;
+
+    position = start;
+
+    for (auto patternIndex=0;patternIndex<patternLength;patternIndex++) {
+        position = findCharacter(textData, position, textLength, patternData[patternIndex]);
+
+        score += MatchScore;
+
+        if ((position==0) || !QChar(textData[position-1]).isLetterOrNumber()) {
+            score += WordStartBonus;
+        }
+
+        if (previousMatch!=-1) {
+            auto gap = position-previousMatch-1;
+
+            if (gap==0) {
+                score += ConsecutiveBonus;
+            } else {
+                score -= qMin(GapStartPenalty+((gap-1)*GapExtensionPenalty), MaximumGapPenalty);
+            }
+        }
+
+        previousMatch = position;
+
+        position++;
+    }
+
+    return qMax(score, 0);
+}
+
+auto Nedrysoft::SettingsDialog::FuzzyMatcher::scoreFields(const QStringList &fields) -> int {
+    auto bestScore = -1;
+
+    for (auto field=0;(field<fields.count()) && (field<FieldCount);field++) {
+        auto fieldScore = score(fields.at(field));
+
+        if (fieldScore>=0) {
+            bestScore = qMax(bestScore, fieldScore*FieldWeights[field]);
+        }
+    }
+
+    return bestScore;
+}
+
+auto Nedrysoft::SettingsDialog::FuzzyMatcher::normalise(const QString &text) -> QString {
+    auto decomposedText = text.toCaseFolded().normalized(QString::NormalizationForm_KD);
+
+    QString normalisedText;
+
+    normalisedText.reserve(decomposedText.length());
+
+    for (auto character : decomposedText) {
+        auto category = character.category();
+
+        if ((category==QChar::Mark_NonSpacing) ||
+            (category==QChar::Mark_SpacingCombining) ||
+            (category==QChar::Mark_Enclosing)) {
+
+            continue;
+        }
+
+        normalisedText.append(character.isSpace() ? QChar(' ') : character);
+    }
+
+    return normalisedText;
+}
+
+auto Nedrysoft::SettingsDialog::FuzzyMatcher::findCharacter(
+        const ushort *data,
+        int from,
+        int length,
+        ushort character) -> int {
+
+    auto position = from;
+
+#if defined(NEDRYSOFT_FUZZYMATCHER_AVX2)
+    auto needle = _mm256_set1_epi16(static_cast<short>(character));
+
+    for (;position+16<=length;position+=16) {
+        auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data+position));
+        auto mask = static_cast<quint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(block, needle)));
+
+        if (mask) {
+            return position+static_cast<int>(qCountTrailingZeroBits(mask)/2);
+        }
+    }
+#elif defined(NEDRYSOFT_FUZZYMATCHER_SSE2)
+    auto needle = _mm_set1_epi16(static_cast<short>(character));
+
+    for (;position+8<=length;position+=8) {
+        auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data+position));
+        auto mask = static_cast<quint32>(_mm_movemask_epi8(_mm_cmpeq_epi16(block, needle)));
+
+        if (mask) {
+            return position+static_cast<int>(qCountTrailingZeroBits(mask)/2);
+        }
+    }
+#endif
+
+    for (;position<length;position++) {
+        if (data[position]==character) {
+            return position;
+        }
+    }
+
+    return -1;
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_FUZZYMATCHER_H
+#define NEDRYSOFT_FUZZYMATCHER_H
+
+#include <QString>
+#include <QStringList>
+
+namespace Nedrysoft { namespace SettingsDialog {
+    /**
+     * @brief       The FuzzyMatcher class provides typo tolerant subsequence matching.
+     *
+     * @details     A pattern matches a text if every character of the pattern appears in the text in the same
+     *              order, the score rewards consecutive characters and characters at the start of words and
+     *              penalises gaps.  Both the pattern and the text must be normalised with normalise() ahead of
+     *              time, the scan for each pattern character uses SSE2 or AVX2 when available.
+     */
+    class FuzzyMatcher {
+        public:
+            /**
+             * @brief       The fields of a page in the order expected by scoreFields().
+             */
+            enum Field {
+                Section = 0,
+                Category,
+                Description,
+                Content,
+                FieldCount
+            };
+
+            /**
+             * @brief       Constructs a new FuzzyMatcher for a pattern.
+             *
+             * @param[in]   pattern the pattern, whitespace is ignored.
+             */
+            explicit FuzzyMatcher(const QString &pattern);
+
+            /**
+             * @brief       Returns whether the pattern is empty.
+             *
+             * @returns     true if empty; otherwise false.
+             */
+            auto isEmpty() -> bool;
+
+            /**
+             * @brief       Scores a normalised text against the pattern.
+             *
+             * @param[in]   text the normalised text.
+             *
+             * @returns     the score if the text matches; otherwise -1.
+             */
+            auto score(const QString &text) -> int;
+
+            /**
+             * @brief       Scores the normalised fields of a page against the pattern.
+             *
+             * @details     The score of each field is weighted so that matches in the section and category rank
+             *              above matches in the description, which in turn rank above matches in the content.
+             *
+             * @param[in]   fields the normalised fields, indexed by Field.
+             *
+             * @returns     the highest weighted score if any field matches; otherwise -1.
+             */
+            auto scoreFields(const QStringList &fields) -> int;
+
+            /**
+             * @brief       Normalises text for matching.
+             *
+             * @details     The text is case folded and decomposed, combining marks are removed so that accented
+             *              characters match their unaccented form.
+             *
+             * @param[in]   text the text to normalise.
+             *
+             * @returns     the normalised text.
+             */
+            static auto normalise(const QString &text) -> QString;
+
+        private:
+            /**
+             * @brief       Finds the next occurrence of a character.
+             *
+             * @param[in]   data the text to search.
+             * @param[in]   from the position to start searching from.
+             * @param[in]   length the length of the text.
+             * @param[in]   character the character to find.
+             *
+             * @returns     the position of the character if found; otherwise -1.
+             */
+            static auto findCharacter(const ushort *data, int from, int length, ushort character) -> int;
+
+        private:
+            //! @cond
+
+            QString m_pattern;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_FUZZYMATCHER_H
@@ -27,8 +27,12 @@
 #include "SettingsDialogSpec.h"
 
 #include <IInterface>
+#include <QStringList>
+#include <QVariant>
 
 namespace Nedrysoft { namespace SettingsDialog {
+    class ConstraintRegistry;
+
     /**
      * @brief       The Settings Page class defines a settings page.
      */
@@ -90,13 +94,267 @@ namespace Nedrysoft { namespace SettingsDialog {
              */
             virtual auto acceptSettings() -> void = 0;
 
+            /**
+             * @brief       The ordering weight of this settings page, lower weights are shown first.
+             *
+             * @details     Sections and categories are ordered by the lowest weight of the pages that they
+             *              contain, pages with equal weights keep the order that they were added in.
+             *
+             * @returns     the weight.
+             */
+            virtual auto weight() -> int {
+                return 0;
+            }
+
+            /**
+             * @brief       The unique identifier of this settings page.
+             *
+             * @details     The identifier is used as the key for information that is cached between sessions, the
+             *              default implementation uses the class name of the page.
+             *
+             * @returns     a string containing the identifier.
+             */
+            virtual auto identifier() -> QString {
+                return QString::fromLatin1(metaObject()->className());
+            }
+
+            /**
+             * @brief       The version of this settings page.
+             *
+             * @details     Information cached for the page is discarded when the version changes, pages should
+             *              change the version whenever the content of their widget changes.
+             *
+             * @returns     a string containing the version.
+             */
+            virtual auto version() -> QString {
+                return QString();
+            }
+
+            /**
+             * @brief       Additional search keywords for this settings page.
+             *
+             * @details     The keywords are indexed alongside the section, category and description so that the
+             *              page can be found by terms that do not appear in its title.
+             *
+             * @returns     the list of keywords.
+             */
+            virtual auto keywords() -> QStringList {
+                return QStringList();
+            }
+
+            /**
+             * @brief       The searchable option text of this settings page.
+             *
+             * @details     Pages that return their option text here can be searched before their widget has been
+             *              created.  Otherwise the widget is crawled for its text once the page has been shown, so
+             *              the options of a page that has not been shown cannot be found unless the application
+             *              enables SettingsDialog::setBackgroundCrawl(), which crawls a temporary instance of the
+             *              widget.  The crawled text is cached between sessions.
+             *
+             * @returns     the list of option text, or an empty list if the widget should be crawled.
+             */
+            virtual auto searchText() -> QStringList {
+                return QStringList();
+            }
+
+            /**
+             * @brief       Called when the page becomes visible to the user.
+             *
+             * @details     Pages that run timers, previews or other background work should resume it here.
+             */
+            virtual auto pageShown() -> void {
+
+            }
+
+            /**
+             * @brief       Called when the page is no longer visible to the user.
+             *
+             * @details     This is called when the user navigates away from the page or when the dialog is hidden
+             *              or minimised, pages should pause any background work until pageShown() is called.
+             */
+            virtual auto pageHidden() -> void {
+
+            }
+
+            /**
+             * @brief       Checks if the settings of this page can be applied on a worker thread.
+             *
+             * @details     Pages whose apply step is slow (for example rewriting files or restarting services)
+             *              should return true, captureSettings() is then called on the GUI thread followed by
+             *              applyCapturedSettings() on a worker thread instead of acceptSettings().
+             *
+             * @returns     true if the settings can be applied in the background; otherwise false.
+             */
+            virtual auto canApplyInBackground() -> bool {
+                return false;
+            }
+
+            /**
+             * @brief       Captures the current settings from the page widget so that they can be applied in the
+             *              background.
+             */
+            virtual auto captureSettings() -> void {
+
+            }
+
+            /**
+             * @brief       Applies the settings captured by captureSettings().
+             *
+             * @note        This is called on a worker thread and must not access the page widget.
+             *
+             * @returns     true if the settings were applied; otherwise false.
+             */
+            virtual auto applyCapturedSettings() -> bool {
+                return true;
+            }
+
+            /**
+             * @brief       Checks if this page supports the transactional apply protocol.
+             *
+             * @details     Transactional pages stage their changes in prepareSettings() and make them permanent in
+             *              commitSettings(), the dialog only commits once every transactional page has been
+             *              prepared so that a failure to prepare leaves the settings of all such pages unchanged.
+             *              If a commit fails then the pages that were already committed are reverted with
+             *              revertSettings().  The methods are called in place of acceptSettings() and
+             *              applyCapturedSettings().
+             *
+             * @returns     true if the page is transactional; otherwise false.
+             */
+            virtual auto isTransactional() -> bool {
+                return false;
+            }
+
+            /**
+             * @brief       Stages the current settings without making them permanent.
+             *
+             * @note        If canApplyInBackground() returns true then this is called on a worker thread after
+             *              captureSettings(), and must not access the page widget.
+             *
+             * @returns     true if the settings were staged; otherwise false.
+             */
+            virtual auto prepareSettings() -> bool {
+                return true;
+            }
+
+            /**
+             * @brief       Makes the staged settings permanent.
+             *
+             * @details     This is called on the GUI thread once every transactional page has been prepared, it
+             *              should be quick and is not expected to fail (for example replacing a file with the
+             *              staged copy).
+             *
+             * @returns     true if the settings were committed; otherwise false.
+             */
+            virtual auto commitSettings() -> bool {
+                return true;
+            }
+
+            /**
+             * @brief       Discards the staged settings.
+             *
+             * @details     This is called if the staged settings are no longer wanted, either because the page
+             *              was changed again or because the dialog was closed without the apply completing.
+             */
+            virtual auto rollbackSettings() -> void {
+
+            }
+
+            /**
+             * @brief       Reverts settings that have been committed.
+             *
+             * @details     This is called on the GUI thread if another transactional page fails to commit after
+             *              this page was committed, the page should restore the settings that the commit replaced.
+             *              A page that cannot revert is left committed and is not applied again when the apply is
+             *              retried.
+             *
+             * @returns     true if the committed settings were reverted; otherwise false.
+             */
+            virtual auto revertSettings() -> bool {
+                return false;
+            }
+
+            /**
+             * @brief       Returns the current values of the settings of this page.
+             *
+             * @details     The keys are the keys of the settings in the SettingsStore.  The dialog compares the
+             *              values with those captured when the page was created, a page with no changes is not
+             *              applied and the changed values are written to the store by the dialog.
+             *
+             * @returns     the values, or an empty map if the page does not report its values.
+             */
+            virtual auto settingsSnapshot() -> QVariantMap {
+                return QVariantMap();
+            }
+
+            /**
+             * @brief       Sets the values that have changed since the page was last applied.
+             *
+             * @details     This is called before the page is applied so that the page only needs to act on the
+             *              settings that changed, a removed setting has an invalid value.
+             *
+             * @param[in]   changes the changed values.
+             */
+            virtual auto setChangedSettings(const QVariantMap &changes) -> void {
+                Q_UNUSED(changes)
+            }
+
+            /**
+             * @brief       Sets the edited value of a setting on this page.
+             *
+             * @details     This is used to undo and redo edits, the page should update its widget and emit
+             *              settingValueChanged() and settingsChanged() as it would for an edit by the user.
+             *
+             * @param[in]   key the key of the setting.
+             * @param[in]   value the new value.
+             *
+             * @returns     true if the value was set; otherwise false.
+             */
+            virtual auto setSettingValue(const QString &key, const QVariant &value) -> bool {
+                Q_UNUSED(key)
+                Q_UNUSED(value)
+
+                return false;
+            }
+
+            /**
+             * @brief       Registers the constraints of this page.
+             *
+             * @details     Constraints are used for settings that depend on settings on other pages, the page is
+             *              only valid while its constraints are satisfied.  The values of the keys that the
+             *              constraints read are reported with settingValueChanged().
+             *
+             * @param[in]   registry the registry to add the constraints to.
+             */
+            virtual auto registerConstraints(ConstraintRegistry *registry) -> void {
+                Q_UNUSED(registry)
+            }
+
             /**
              * @brief       Emitted when the pages settings have changed.
              */
             Q_SIGNAL void settingsChanged();
+
+            /**
+             * @brief       Emitted when the edited value of a setting has changed.
+             *
+             * @note        This does not replace settingsChanged(), which should also be emitted.
+             *
+             * @param[in]   key the key of the setting.
+             * @param[in]   value the new value.
+             */
+            Q_SIGNAL void settingValueChanged(const QString &key, const QVariant &value);
+
+            /**
+             * @brief       Emitted to report the progress of applying the settings.
+             *
+             * @note        This may be emitted from the worker thread by applyCapturedSettings().
+             *
+             * @param[in]   percent the percentage of the page settings that have been applied.
+             */
+            Q_SIGNAL void applyProgress(int percent);
     };
 }}
 
-Q_DECLARE_INTERFACE(Nedrysoft::SettingsDialog::ISettingsPage, "com.nedrysoft.settingsdialog.ISettingsPage/1.0.0")
+Q_DECLARE_INTERFACE(Nedrysoft::SettingsDialog::ISettingsPage, "com.nedrysoft.settingsdialog.ISettingsPage/2.0.0")
 
 #endif // NEDRYSOFT_ISETTINGSPAGE_H
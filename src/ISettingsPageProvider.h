@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_ISETTINGSPAGEPROVIDER_H
+#define NEDRYSOFT_ISETTINGSPAGEPROVIDER_H
+
+#include "SettingsDialogSpec.h"
+
+#include <QObject>
+#include <QString>
+
+namespace Nedrysoft { namespace SettingsDialog {
+    class ISettingsPage;
+
+    /**
+     * @brief       The ISettingsPageProvider interface is implemented by the root object of a plugin that
+     *              declares its settings pages in its metadata.
+     *
+     * @details     The pages are described in the plugin JSON metadata so that the navigation can be built
+     *              without loading the plugin.  With SettingsPagePlugin::resolver() the plugin is loaded and asked
+     *              for a page the first time that the page is opened or applied, with SettingsPageLoader the
+     *              plugin is loaded and asked for all of its pages on a worker thread.
+     */
+    class SETTINGS_DIALOG_DLLSPEC ISettingsPageProvider {
+        public:
+            /**
+             * @brief       Destroys the ISettingsPageProvider.
+             */
+            virtual ~ISettingsPageProvider() = default;
+
+            /**
+             * @brief       Creates a settings page.
+             *
+             * @param[in]   identifier the identifier of the page as declared in the plugin metadata.
+             *
+             * @returns     the page if the identifier is known; otherwise nullptr.
+             */
+            virtual auto createPage(const QString &identifier) -> ISettingsPage * = 0;
+    };
+}}
+
+Q_DECLARE_INTERFACE(Nedrysoft::SettingsDialog::ISettingsPageProvider, "com.nedrysoft.settingsdialog.ISettingsPageProvider/1.0.0")
+
+#endif // NEDRYSOFT_ISETTINGSPAGEPROVIDER_H
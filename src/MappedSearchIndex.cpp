@@ -0,0 +1,426 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MappedSearchIndex.h"
+
+#include "SearchIndex.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QMap>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+
+constexpr quint32 IndexMagic = 0x4e534d49;
+constexpr quint32 IndexFormatVersion = 1;
+constexpr quint64 KeyOffsetBasis = 0xcbf29ce484222325ULL;
+constexpr quint64 KeyPrime = 0x100000001b3ULL;
+constexpr auto IndexFileName = "SettingsDialog/SearchIndex.index";
+
+//! @cond
+
+struct Nedrysoft::SettingsDialog::MappedSearchIndex::Header {
+    quint32 m_magic;
+    quint32 m_formatVersion;
+    quint64 m_key;
+    quint32 m_termCount;
+    quint32 m_documentCount;
+    quint32 m_termsOffset;
+    quint32 m_documentsOffset;
+    quint32 m_stringsOffset;
+    quint32 m_stringsLength;
+    quint32 m_postingsOffset;
+    quint32 m_postingsCount;
+};
+
+struct Nedrysoft::SettingsDialog::MappedSearchIndex::Term {
+    quint32 m_stringOffset;
+    quint32 m_stringLength;
+    quint32 m_postingsOffset;
+    quint32 m_postingsCount;
+};
+
+struct Nedrysoft::SettingsDialog::MappedSearchIndex::Document {
+    quint32 m_stringOffset;
+    quint32 m_stringLength;
+};
+
+//! @endcond
+
+namespace {
+    /**
+     * @brief       Compares two UTF-16 strings by code unit.
+     *
+     * @param[in]   left the first string.
+     * @param[in]   leftLength the length of the first string.
+     * @param[in]   right the second string.
+     * @param[in]   rightLength the length of the second string.
+     *
+     * @returns     a negative value, zero or a positive value if left is less than, equal to or greater than right.
+     */
+    auto compareStrings(const ushort *left, quint32 leftLength, const ushort *right, quint32 rightLength) -> int {
+        auto length = qMin(leftLength, rightLength);
+
+        for (quint32 index=0;index<length;index++) {
+            if (left[index]!=right[index]) {
+                return (left[index]<right[index]) ? -1 : 1;
+            }
+        }
+
+        return (leftLength<rightLength) ? -1 : ((leftLength>rightLength) ? 1 : 0);
+    }
+}
+
+Nedrysoft::SettingsDialog::MappedSearchIndex::MappedSearchIndex() :
+        m_data(nullptr),
+        m_header(nullptr),
+        m_terms(nullptr),
+        m_documents(nullptr),
+        m_strings(nullptr),
+        m_postings(nullptr) {
+
+}
+
+Nedrysoft::SettingsDialog::MappedSearchIndex::~MappedSearchIndex() {
+    close();
+}
+
+auto Nedrysoft::SettingsDialog::MappedSearchIndex::defaultFileName() -> QString {
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath(IndexFileName);
+}
+
+auto Nedrysoft::SettingsDialog::MappedSearchIndex::key(const QStringList &pages) -> quint64 {
+    auto hash = KeyOffsetBasis;
+
+    for (auto &page : pages) {
+        auto data = reinterpret_cast<const ushort *>(page.utf16());
+
+        for (auto index=0;index<=page.length();index++) {
+            // the terminating null is included so that the boundary between pages forms part of the key
+
+            hash = (hash^data[index])*KeyPrime;
+        }
+    }
+
+    return hash;
+}
+
+auto Nedrysoft::SettingsDialog::MappedSearchIndex::write(
+        const QString &fileName,
+        quint64 key,
+        const QVector<QStringList> &documents) -> bool {
+
+    QMap<QString, QVector<quint32> > termDocuments;
+
+    for (auto document=0;document<documents.count();document++) {
+        for (auto &field : documents.at(document)) {
+            for (auto &word : SearchIndex::tokenise(field)) {
+                auto &wordDocuments = termDocuments[word];
+
+                if (wordDocuments.isEmpty() || (wordDocuments.last()!=static_cast<quint32>(document))) {
+                    wordDocuments.append(static_cast<quint32>(document));
+                }
+            }
+        }
+    }
+
+    auto terms = termDocuments.keys();
+
+    std::sort(terms.begin(), terms.end(), [](const QString &left, const QString &right) {
+        return compareStrings(
+                reinterpret_cast<const ushort *>(left.utf16()),
+                static_cast<quint32>(left.length()),
+                reinterpret_cast<const ushort *>(right.utf16()),
+                static_cast<quint32>(right.length()) )<0;
+    });
+
+    QVector<Term> termTable;
+    QVector<Document> documentTable;
+    QVector<ushort> strings;
+    QVector<quint32> postings;
+
+    auto appendString = [&strings](const QString &string) {
+        auto data = reinterpret_cast<const ushort *>(string.utf16());
+
+        for (auto index=0;index<string.length();index++) {
+            strings.append(data[index]);
+        }
+    };
+
+    termTable.reserve(terms.count());
+    documentTable.reserve(documents.count());
+
+    for (auto &term : terms) {
+        auto &termPostings = termDocuments[term];
+
+        termTable.append(Term{
+            static_cast<quint32>(strings.count()),
+            static_cast<quint32>(term.length()),
+            static_cast<quint32>(postings.count()),
+            static_cast<quint32>(termPostings.count()) });
+
+        appendString(term);
+        postings.append(termPostings);
+    }
+
+    for (auto &document : documents) {
+        auto text = document.isEmpty() ? QString() : document.last();
+
+        documentTable.append(Document{
+            static_cast<quint32>(strings.count()),
+            static_cast<quint32>(text.length()) });
+
+        appendString(text);
+    }
+
+    // the string table is padded so that the postings that follow it are aligned
+
+    if (strings.count()%2) {
+        strings.append(0);
+    }
+
+    Header header;
+
+    header.m_magic = IndexMagic;
+    header.m_formatVersion = IndexFormatVersion;
+    header.m_key = key;
+    header.m_termCount = static_cast<quint32>(termTable.count());
+    header.m_documentCount = static_cast<quint32>(documentTable.count());
+    header.m_termsOffset = sizeof(Header);
+    header.m_documentsOffset = header.m_termsOffset+(header.m_termCount*sizeof(Term));
+    header.m_stringsOffset = header.m_documentsOffset+(header.m_documentCount*sizeof(Document));
+    header.m_stringsLength = static_cast<quint32>(strings.count());
+    header.m_postingsOffset = header.m_stringsOffset+(header.m_stringsLength*sizeof(ushort));
+    header.m_postingsCount = static_cast<quint32>(postings.count());
+
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+
+    QSaveFile file(fileName);
+
+    if (!file.open(QFile::WriteOnly)) {
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+    file.write(reinterpret_cast<const char *>(termTable.constData()), termTable.count()*sizeof(Term));
+    file.write(reinterpret_cast<const char *>(documentTable.constData()), documentTable.count()*sizeof(Document));
+    file.write(reinterpret_cast<const char *>(strings.constData()), strings.count()*sizeof(ushort));
+    file.write(reinterpret_cast<const char *>(postings.constData()), postings.count()*sizeof(quint32));
+
+    return file.commit();
+}
+
+auto Nedrysoft::SettingsDialog::MappedSearchIndex::open(const QString &fileName, quint64 key) -> bool {
+    close();
+
+    m_file.setFileName(fileName);
+
+    if (!m_file.open(QFile::ReadOnly)) {
+        return false;
+    }
+
+    auto fileSize = static_cast<quint64>(m_file.size());
+
+    if (fileSize<sizeof(Header)) {
+        m_file.close();
+
+        return false;
+    }
+
+    m_data = m_file.map(0, m_file.size());
+
+    if (!m_data) {
+        m_file.close();
+
+        return false;
+    }
+
+    auto header = reinterpret_cast<const Header *>(m_data);
+
+    auto isValid = (header->m_magic==IndexMagic) &&
+                   (header->m_formatVersion==IndexFormatVersion) &&
+                   (header->m_key==key) &&
+                   (header->m_termsOffset+(static_cast<quint64>(header->m_termCount)*sizeof(Term))<=fileSize) &&
+                   (header->m_documentsOffset+(static_cast<quint64>(header->m_documentCount)*sizeof(Document))<=fileSize) &&
+                   (header->m_stringsOffset+(static_cast<quint64>(header->m_stringsLength)*sizeof(ushort))<=fileSize) &&
+                   (header->m_postingsOffset+(static_cast<quint64>(header->m_postingsCount)*sizeof(quint32))<=fileSize) &&
+                   !(header->m_postingsOffset%sizeof(quint32));
+
+    if (!isValid) {
+        close();
+
+        return false;
+    }
+
+    m_header = header;
+    m_terms = reinterpret_cast<const Term *>(m_data+header->m_termsOffset);
+    m_documents = reinterpret_cast<const Document *>(m_data+header->m_documentsOffset);
+    m_strings = reinterpret_cast<const ushort *>(m_data+header->m_stringsOffset);
+    m_postings = reinterpret_cast<const quint32 *>(m_data+header->m_postingsOffset);
+
+    // the match counts used by find() are allocated once here rather than for every query
+
+    m_matchedTerms.fill(0, static_cast<int>(header->m_documentCount));
+
+    return true;
+}
+
+auto Nedrysoft::SettingsDialog::MappedSearchIndex::close() -> void {
+    if (m_data) {
+        m_file.unmap(const_cast<uchar *>(m_data));
+    }
+
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+
+    m_data = nullptr;
+    m_header = nullptr;
+    m_terms = nullptr;
+    m_documents = nullptr;
+    m_strings = nullptr;
+    m_postings = nullptr;
+
+    m_matchedTerms.clear();
+}
+
+auto Nedrysoft::SettingsDialog::MappedSearchIndex::isOpen() -> bool {
+    return m_header!=nullptr;
+}
+
+auto Nedrysoft::SettingsDialog::MappedSearchIndex::documentCount() -> int {
+    if (!m_header) {
+        return 0;
+    }
+
+    return static_cast<int>(m_header->m_documentCount);
+}
+
+auto Nedrysoft::SettingsDialog::MappedSearchIndex::text(int document) -> QString {
+    if ((document<0) || (document>=documentCount())) {
+        return QString();
+    }
+
+    auto &entry = m_documents[document];
+
+    if (entry.m_stringOffset+static_cast<quint64>(entry.m_stringLength)>m_header->m_stringsLength) {
+        return QString();
+    }
+
+    return QString::fromRawData(reinterpret_cast<const QChar *>(m_strings+entry.m_stringOffset), entry.m_stringLength);
+}
+
+auto Nedrysoft::SettingsDialog::MappedSearchIndex::find(const QString &query) -> QVector<int> {
+    QVector<int> documents;
+
+    if (!m_header) {
+        return documents;
+    }
+
+    // the query is split into terms in the same way as the in-memory index, so both indexes return the same pages
+
+    auto terms = SearchIndex::tokenise(query);
+
+    if (terms.isEmpty()) {
+        return documents;
+    }
+
+    // each document counts the query terms that it has matched so far, a document only advances when it matches
+    // the next term so that a term with several matching words is only counted once.  The counts are reset in
+    // place rather than allocated for each query, the terms of the query and the result are still allocated.
+
+    auto &matchedTerms = m_matchedTerms;
+
+    std::fill(matchedTerms.begin(), matchedTerms.end(), 0);
+
+    for (auto termIndex=0;termIndex<terms.count();termIndex++) {
+        auto &prefix = terms.at(termIndex);
+
+        for (auto term=lowerBound(prefix);(term<m_header->m_termCount) && termStartsWith(term, prefix);term++) {
+            auto &entry = m_terms[term];
+
+            if (entry.m_postingsOffset+static_cast<quint64>(entry.m_postingsCount)>m_header->m_postingsCount) {
+                continue;
+            }
+
+            auto termPostings = m_postings+entry.m_postingsOffset;
+
+            for (quint32 posting=0;posting<entry.m_postingsCount;posting++) {
+                auto document = termPostings[posting];
+
+                if ((document<m_header->m_documentCount) && (matchedTerms[document]==termIndex)) {
+                    matchedTerms[document] = termIndex+1;
+                }
+            }
+        }
+    }
+
+    for (auto document=0;document<matchedTerms.count();document++) {
+        if (matchedTerms.at(document)==terms.count()) {
+            documents.append(document);
+        }
+    }
+
+    return documents;
+}
+
+auto Nedrysoft::SettingsDialog::MappedSearchIndex::lowerBound(const QString &prefix) -> quint32 {
+    quint32 first = 0;
+    quint32 count = m_header->m_termCount;
+
+    while (count) {
+        auto step = count/2;
+        auto &entry = m_terms[first+step];
+
+        auto comparison = compareStrings(
+                m_strings+qMin(entry.m_stringOffset, m_header->m_stringsLength),
+                qMin(entry.m_stringLength, m_header->m_stringsLength-qMin(entry.m_stringOffset, m_header->m_stringsLength)),
+                reinterpret_cast<const ushort *>(prefix.utf16()),
+                static_cast<quint32>(prefix.length()) );
+
+        if (comparison<0) {
+            first += step+1;
+            count -= step+1;
+        } else {
+            count = step;
+        }
+    }
+
+    return first;
+}
+
+auto Nedrysoft::SettingsDialog::MappedSearchIndex::termStartsWith(quint32 term, const QString &prefix) -> bool {
+    auto &entry = m_terms[term];
+    auto prefixLength = static_cast<quint32>(prefix.length());
+
+    if ((entry.m_stringLength<prefixLength) ||
+        (entry.m_stringOffset+static_cast<quint64>(prefixLength)>m_header->m_stringsLength)) {
+
+        return false;
+    }
+
+    return compareStrings(
+            m_strings+entry.m_stringOffset,
+            prefixLength,
+            reinterpret_cast<const ushort *>(prefix.utf16()),
+            prefixLength )==0;
+}
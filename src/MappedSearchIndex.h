@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_MAPPEDSEARCHINDEX_H
+#define NEDRYSOFT_MAPPEDSEARCHINDEX_H
+
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace Nedrysoft { namespace SettingsDialog {
+    /**
+     * @brief       The MappedSearchIndex class provides a read-only search index that is memory mapped from disk.
+     *
+     * @details     The file consists of a header, a sorted table of terms, a UTF-16 string table and the sorted
+     *              document lists of each term.  The file is used in place once mapped, opening it only validates
+     *              the header and queries do not parse or copy any of the index.
+     *
+     *              The index is keyed by the set of pages that it was built from, a file built for a different
+     *              set of pages is rejected so that it can be rebuilt.
+     */
+    class MappedSearchIndex {
+        public:
+            /**
+             * @brief       Constructs a new MappedSearchIndex with no file open.
+             */
+            MappedSearchIndex();
+
+            /**
+             * @brief       Destroys the MappedSearchIndex.
+             */
+            ~MappedSearchIndex();
+
+            /**
+             * @brief       Returns the default location of the index file.
+             *
+             * @returns     the file name.
+             */
+            static auto defaultFileName() -> QString;
+
+            /**
+             * @brief       Returns the key for a set of pages.
+             *
+             * @param[in]   pages the identifier, version and indexed text of each page, in page order.
+             *
+             * @returns     the key.
+             */
+            static auto key(const QStringList &pages) -> quint64;
+
+            /**
+             * @brief       Writes an index file.
+             *
+             * @param[in]   fileName the file to write.
+             * @param[in]   key the key of the set of pages.
+             * @param[in]   documents the normalised text fields of each document, the last field of each document
+             *              is also stored so that it can be retrieved with text().
+             *
+             * @returns     true if the file was written; otherwise false.
+             */
+            static auto write(const QString &fileName, quint64 key, const QVector<QStringList> &documents) -> bool;
+
+            /**
+             * @brief       Maps an index file.
+             *
+             * @param[in]   fileName the file to map.
+             * @param[in]   key the key of the current set of pages.
+             *
+             * @returns     true if the file was mapped and matches the key; otherwise false.
+             */
+            auto open(const QString &fileName, quint64 key) -> bool;
+
+            /**
+             * @brief       Unmaps the index file.
+             */
+            auto close() -> void;
+
+            /**
+             * @brief       Returns whether an index file is mapped.
+             *
+             * @returns     true if mapped; otherwise false.
+             */
+            auto isOpen() -> bool;
+
+            /**
+             * @brief       Returns the number of documents in the index.
+             *
+             * @returns     the number of documents.
+             */
+            auto documentCount() -> int;
+
+            /**
+             * @brief       Returns the stored text of a document.
+             *
+             * @note        The returned string refers directly to the mapped file and is only valid until the
+             *              index is closed.
+             *
+             * @param[in]   document the document.
+             *
+             * @returns     the text.
+             */
+            auto text(int document) -> QString;
+
+            /**
+             * @brief       Finds the documents that match a query.
+             *
+             * @details     A document matches if every term in the query is a prefix of a word in the document.
+             *
+             * @param[in]   query the text to search for.
+             *
+             * @returns     the sorted list of matching document identifiers.
+             */
+            auto find(const QString &query) -> QVector<int>;
+
+        private:
+            /**
+             * @brief       Returns the index of the first term that is not less than a prefix.
+             *
+             * @param[in]   prefix the prefix.
+             *
+             * @returns     the index of the term.
+             */
+            auto lowerBound(const QString &prefix) -> quint32;
+
+            /**
+             * @brief       Returns whether a term starts with a prefix.
+             *
+             * @param[in]   term the index of the term.
+             * @param[in]   prefix the prefix.
+             *
+             * @returns     true if the term starts with the prefix; otherwise false.
+             */
+            auto termStartsWith(quint32 term, const QString &prefix) -> bool;
+
+        private:
+            //! @cond
+
+            struct Header;
+            struct Term;
+            struct Document;
+
+            QFile m_file;
+            const uchar *m_data;
+            const Header *m_header;
+            const Term *m_terms;
+            const Document *m_documents;
+            const ushort *m_strings;
+            const quint32 *m_postings;
+            QVector<int> m_matchedTerms;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_MAPPEDSEARCHINDEX_H
@@ -0,0 +1,295 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PageMetadataCache.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QIcon>
+#include <QImage>
+#include <QList>
+#include <QPixmap>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+constexpr quint32 CacheMagic = 0x4e53504d;
+constexpr quint32 CacheFormatVersion = 3;
+constexpr auto CacheStreamVersion = QDataStream::Qt_5_12;
+constexpr auto CacheFileName = "SettingsDialog/PageMetadata.cache";
+constexpr int CacheIconSizes[] = {16, 32, 64, 128, 256};
+constexpr auto MaximumIconSize = 1024;
+constexpr auto MaximumIconImages = 16;
+constexpr auto MaximumDevicePixelRatio = 16.0;
+
+Nedrysoft::SettingsDialog::PageMetadataCache::PageMetadataCache() :
+        m_isModified(false) {
+
+}
+
+auto Nedrysoft::SettingsDialog::PageMetadataCache::defaultFileName() -> QString {
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath(CacheFileName);
+}
+
+auto Nedrysoft::SettingsDialog::PageMetadataCache::load(const QString &fileName) -> bool {
+    QFile file(fileName);
+
+    if (!file.open(QFile::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+
+    stream.setVersion(CacheStreamVersion);
+
+    quint32 magic = 0, formatVersion = 0, entryCount = 0;
+
+    stream >> magic >> formatVersion;
+
+    if ((magic!=CacheMagic) || (formatVersion!=CacheFormatVersion)) {
+        return false;
+    }
+
+    stream >> entryCount;
+
+    QMap<QString, Entry> entries;
+
+    for (quint32 entryIndex=0;entryIndex<entryCount;entryIndex++) {
+        QString pluginFileName;
+        Entry entry;
+        quint32 descriptorCount = 0;
+
+        stream >> pluginFileName >> entry.m_size >> entry.m_lastModified >> descriptorCount;
+
+        for (quint32 descriptorIndex=0;descriptorIndex<descriptorCount;descriptorIndex++) {
+            SettingsPageDescriptor descriptor;
+            qint32 weight = 0;
+
+            stream >> descriptor.m_identifier
+                   >> descriptor.m_version
+                   >> descriptor.m_section
+                   >> descriptor.m_category
+                   >> descriptor.m_description
+                   >> descriptor.m_keywords
+                   >> weight;
+
+            descriptor.m_weight = weight;
+            descriptor.m_icon = readIcon(stream);
+            descriptor.m_darkIcon = readIcon(stream);
+
+            entry.m_descriptors.append(descriptor);
+        }
+
+        if (stream.status()!=QDataStream::Ok) {
+            return false;
+        }
+
+        entries[pluginFileName] = entry;
+    }
+
+    m_entries = entries;
+    m_isModified = false;
+
+    return true;
+}
+
+auto Nedrysoft::SettingsDialog::PageMetadataCache::save(const QString &fileName) -> bool {
+    for (auto entry=m_entries.begin();entry!=m_entries.end();) {
+        if (!QFileInfo::exists(entry.key())) {
+            entry = m_entries.erase(entry);
+        } else {
+            entry++;
+        }
+    }
+
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+
+    QSaveFile file(fileName);
+
+    if (!file.open(QFile::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+
+    stream.setVersion(CacheStreamVersion);
+
+    stream << CacheMagic << CacheFormatVersion << static_cast<quint32>(m_entries.count());
+
+    for (auto entry=m_entries.constBegin();entry!=m_entries.constEnd();entry++) {
+        stream << entry.key()
+               << entry->m_size
+               << entry->m_lastModified
+               << static_cast<quint32>(entry->m_descriptors.count());
+
+        for (auto &descriptor : entry->m_descriptors) {
+            stream << descriptor.m_identifier
+                   << descriptor.m_version
+                   << descriptor.m_section
+                   << descriptor.m_category
+                   << descriptor.m_description
+                   << descriptor.m_keywords
+                   << static_cast<qint32>(descriptor.m_weight);
+
+            writeIcon(stream, descriptor.m_icon);
+            writeIcon(stream, descriptor.m_darkIcon);
+        }
+    }
+
+    if (!file.commit()) {
+        return false;
+    }
+
+    m_isModified = false;
+
+    return true;
+}
+
+auto Nedrysoft::SettingsDialog::PageMetadataCache::contains(const QString &pluginFileName) -> bool {
+    auto entry = m_entries.constFind(QFileInfo(pluginFileName).absoluteFilePath());
+
+    if (entry==m_entries.constEnd()) {
+        return false;
+    }
+
+    QFileInfo fileInfo(entry.key());
+
+    return fileInfo.exists() &&
+           (fileInfo.size()==entry->m_size) &&
+           (fileInfo.lastModified()==entry->m_lastModified);
+}
+
+auto Nedrysoft::SettingsDialog::PageMetadataCache::descriptors(
+        const QString &pluginFileName) -> QList<Nedrysoft::SettingsDialog::SettingsPageDescriptor> {
+
+    if (!contains(pluginFileName)) {
+        return QList<SettingsPageDescriptor>();
+    }
+
+    return m_entries.value(QFileInfo(pluginFileName).absoluteFilePath()).m_descriptors;
+}
+
+auto Nedrysoft::SettingsDialog::PageMetadataCache::setDescriptors(
+        const QString &pluginFileName,
+        const QList<SettingsPageDescriptor> &descriptors) -> void {
+
+    QFileInfo fileInfo(pluginFileName);
+    Entry entry;
+
+    entry.m_size = fileInfo.size();
+    entry.m_lastModified = fileInfo.lastModified();
+    entry.m_descriptors = descriptors;
+
+    m_entries[fileInfo.absoluteFilePath()] = entry;
+
+    m_isModified = true;
+}
+
+auto Nedrysoft::SettingsDialog::PageMetadataCache::isModified() -> bool {
+    return m_isModified;
+}
+
+auto Nedrysoft::SettingsDialog::PageMetadataCache::writeIcon(QDataStream &stream, const QIcon &icon) -> void {
+    QList<QImage> images;
+
+    // every size that the icon provides is stored, so that the icon is drawn from an image of the right size
+    // on high dpi screens.  A scalable icon has no fixed sizes and is rendered at each of the cache sizes.
+
+    if (!icon.isNull()) {
+        auto sizes = icon.availableSizes();
+
+        if (sizes.isEmpty()) {
+            for (auto size : CacheIconSizes) {
+                sizes.append(QSize(size, size));
+            }
+        }
+
+        for (auto &size : sizes) {
+            auto image = icon.pixmap(size).toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+            if (!image.isNull() && (images.count()<MaximumIconImages)) {
+                images.append(image);
+            }
+        }
+    }
+
+    // the pixels are stored uncompressed so that loading the cache does not need to decode any images
+
+    stream << static_cast<qint32>(images.count());
+
+    // the pixmaps of an icon are rendered for the device pixel ratio of the screen, the ratio is stored with each
+    // image so that the icon is restored at the same logical size.
+
+    for (auto &image : images) {
+        stream << static_cast<qint32>(image.width())
+               << static_cast<qint32>(image.height())
+               << static_cast<double>(image.devicePixelRatio());
+
+        for (auto line=0;line<image.height();line++) {
+            stream.writeRawData(reinterpret_cast<const char *>(image.constScanLine(line)), image.width()*4);
+        }
+    }
+}
+
+auto Nedrysoft::SettingsDialog::PageMetadataCache::readIcon(QDataStream &stream) -> QIcon {
+    qint32 imageCount = 0;
+    QIcon icon;
+
+    stream >> imageCount;
+
+    if ((imageCount<0) || (imageCount>MaximumIconImages)) {
+        stream.setStatus(QDataStream::ReadCorruptData);
+
+        return QIcon();
+    }
+
+    for (auto imageIndex=0;imageIndex<imageCount;imageIndex++) {
+        qint32 width = 0, height = 0;
+        double devicePixelRatio = 0;
+
+        stream >> width >> height >> devicePixelRatio;
+
+        if ((width<=0) || (height<=0) || (width>MaximumIconSize) || (height>MaximumIconSize) ||
+            !(devicePixelRatio>0) || (devicePixelRatio>MaximumDevicePixelRatio)) {
+
+            stream.setStatus(QDataStream::ReadCorruptData);
+
+            return QIcon();
+        }
+
+        QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+
+        for (auto line=0;line<height;line++) {
+            if (stream.readRawData(reinterpret_cast<char *>(image.scanLine(line)), width*4)!=width*4) {
+                stream.setStatus(QDataStream::ReadPastEnd);
+
+                return QIcon();
+            }
+        }
+
+        image.setDevicePixelRatio(devicePixelRatio);
+
+        icon.addPixmap(QPixmap::fromImage(image));
+    }
+
+    return icon;
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_PAGEMETADATACACHE_H
+#define NEDRYSOFT_PAGEMETADATACACHE_H
+
+#include "SettingsPageDescriptor.h"
+
+#include <QDateTime>
+#include <QList>
+#include <QMap>
+#include <QString>
+
+class QDataStream;
+class QIcon;
+
+namespace Nedrysoft { namespace SettingsDialog {
+    /**
+     * @brief       The PageMetadataCache class persists the page descriptors of each plugin.
+     *
+     * @details     The descriptors of the pages provided by a plugin are stored against the plugin file, with
+     *              each size of the icons stored as raw pixels so that no image decoding is needed on load.  An entry is only
+     *              valid while the size and modification time of the plugin file are unchanged, which allows the
+     *              navigation to be built on later runs without loading any plugin.
+     */
+    class SETTINGS_DIALOG_DLLSPEC PageMetadataCache {
+        public:
+            /**
+             * @brief       Constructs a new empty PageMetadataCache.
+             */
+            PageMetadataCache();
+
+            /**
+             * @brief       Returns the default location of the cache file.
+             *
+             * @returns     the file name.
+             */
+            static auto defaultFileName() -> QString;
+
+            /**
+             * @brief       Loads the cache from a file.
+             *
+             * @param[in]   fileName the file to load.
+             *
+             * @returns     true if the cache was loaded; otherwise false.
+             */
+            auto load(const QString &fileName) -> bool;
+
+            /**
+             * @brief       Saves the cache to a file.
+             *
+             * @details     Entries for plugin files that no longer exist are discarded.
+             *
+             * @param[in]   fileName the file to save to.
+             *
+             * @returns     true if the cache was saved; otherwise false.
+             */
+            auto save(const QString &fileName) -> bool;
+
+            /**
+             * @brief       Checks whether the cache holds valid descriptors for a plugin.
+             *
+             * @param[in]   pluginFileName the file name of the plugin.
+             *
+             * @returns     true if the plugin file is unchanged since its descriptors were stored; otherwise false.
+             */
+            auto contains(const QString &pluginFileName) -> bool;
+
+            /**
+             * @brief       Returns the cached descriptors for a plugin.
+             *
+             * @param[in]   pluginFileName the file name of the plugin.
+             *
+             * @returns     the descriptors if the entry is valid; otherwise an empty list.
+             */
+            auto descriptors(const QString &pluginFileName) -> QList<SettingsPageDescriptor>;
+
+            /**
+             * @brief       Sets the descriptors for a plugin.
+             *
+             * @param[in]   pluginFileName the file name of the plugin.
+             * @param[in]   descriptors the descriptors of the pages that the plugin provides.
+             */
+            auto setDescriptors(const QString &pluginFileName, const QList<SettingsPageDescriptor> &descriptors) -> void;
+
+            /**
+             * @brief       Returns whether the cache has been modified since it was loaded or saved.
+             *
+             * @returns     true if modified; otherwise false.
+             */
+            auto isModified() -> bool;
+
+        private:
+            /**
+             * @brief       Writes each size of an icon to a stream as raw pixels.
+             *
+             * @details     The device pixel ratio of each image is stored with its pixels.
+             *
+             * @param[in]   stream the stream to write to.
+             * @param[in]   icon the icon to write.
+             */
+            static auto writeIcon(QDataStream &stream, const QIcon &icon) -> void;
+
+            /**
+             * @brief       Reads an icon written by writeIcon().
+             *
+             * @param[in]   stream the stream to read from.
+             *
+             * @returns     the icon.
+             */
+            static auto readIcon(QDataStream &stream) -> QIcon;
+
+        private:
+            //! @cond
+
+            struct Entry {
+                qint64 m_size;
+                QDateTime m_lastModified;
+                QList<SettingsPageDescriptor> m_descriptors;
+            };
+
+            QMap<QString, Entry> m_entries;
+            bool m_isModified;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_PAGEMETADATACACHE_H
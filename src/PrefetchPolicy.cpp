@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrefetchPolicy.h"
+
+#include <QTimer>
+
+constexpr auto DefaultPrefetchDelay = 80;
+constexpr auto NoPage = -1;
+
+Nedrysoft::SettingsDialog::PrefetchPolicy::Statistics::Statistics() :
+        m_requests(0),
+        m_cancellations(0),
+        m_prefetches(0),
+        m_hits(0),
+        m_misses(0),
+        m_unused(0) {
+
+}
+
+Nedrysoft::SettingsDialog::PrefetchPolicy::PrefetchPolicy(QObject *parent) :
+        QObject(parent),
+        m_pendingPage(NoPage) {
+
+    m_timer = new QTimer(this);
+
+    m_timer->setSingleShot(true);
+    m_timer->setInterval(DefaultPrefetchDelay);
+
+    connect(m_timer, &QTimer::timeout, [=]() {
+        auto page = m_pendingPage;
+
+        m_pendingPage = NoPage;
+
+        m_prefetchedPages.insert(page);
+
+        m_statistics.m_prefetches++;
+
+        Q_EMIT prefetch(page);
+    });
+}
+
+auto Nedrysoft::SettingsDialog::PrefetchPolicy::setDelay(int milliseconds) -> void {
+    m_timer->setInterval(milliseconds);
+}
+
+auto Nedrysoft::SettingsDialog::PrefetchPolicy::request(int page, bool isLoaded) -> void {
+    if (page==m_pendingPage) {
+        return;
+    }
+
+    cancel();
+
+    // the delay filters out pages that the pointer only passes over on its way to somewhere else
+
+    if (isLoaded || (page==NoPage)) {
+        return;
+    }
+
+    m_statistics.m_requests++;
+
+    m_pendingPage = page;
+
+    m_timer->start();
+}
+
+auto Nedrysoft::SettingsDialog::PrefetchPolicy::cancel() -> void {
+    if (m_pendingPage==NoPage) {
+        return;
+    }
+
+    m_timer->stop();
+
+    m_pendingPage = NoPage;
+
+    m_statistics.m_cancellations++;
+}
+
+auto Nedrysoft::SettingsDialog::PrefetchPolicy::shown(int page, bool isLoaded) -> void {
+    if (page==m_pendingPage) {
+        // the page was shown before the delay expired, the pending request is no longer needed
+
+        m_timer->stop();
+
+        m_pendingPage = NoPage;
+    }
+
+    if (m_prefetchedPages.remove(page)) {
+        m_statistics.m_hits++;
+    } else if (!isLoaded) {
+        m_statistics.m_misses++;
+    }
+}
+
+auto Nedrysoft::SettingsDialog::PrefetchPolicy::statistics() -> Nedrysoft::SettingsDialog::PrefetchPolicy::Statistics {
+    auto statistics = m_statistics;
+
+    statistics.m_unused = m_prefetchedPages.count();
+
+    return statistics;
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_PREFETCHPOLICY_H
+#define NEDRYSOFT_PREFETCHPOLICY_H
+
+#include <QObject>
+#include <QSet>
+
+class QTimer;
+
+namespace Nedrysoft { namespace SettingsDialog {
+    /**
+     * @brief       The PrefetchPolicy class decides when a page should be created ahead of being shown.
+     *
+     * @details     A request is made when the pointer hovers over a page or a page becomes the best search result,
+     *              if the request is not replaced or cancelled within the delay then prefetch() is emitted.  The
+     *              policy records whether each page was prefetched before being shown so that the delay can be
+     *              tuned from the statistics.
+     */
+    class PrefetchPolicy :
+            public QObject {
+
+        private:
+            Q_OBJECT
+
+        public:
+            /**
+             * @brief       The Statistics class holds the counters of a PrefetchPolicy.
+             *
+             * @details     A hit is a page that was prefetched before it was shown, a miss is a page that had to be
+             *              created when it was shown.  Unused pages were prefetched but have not been shown.
+             */
+            class Statistics {
+                public:
+                    /**
+                     * @brief       Constructs a new Statistics with all counters set to zero.
+                     */
+                    Statistics();
+
+                public:
+                    int m_requests;
+                    int m_cancellations;
+                    int m_prefetches;
+                    int m_hits;
+                    int m_misses;
+                    int m_unused;
+            };
+
+            /**
+             * @brief       Constructs a new PrefetchPolicy.
+             *
+             * @param[in]   parent the owner of the policy.
+             */
+            explicit PrefetchPolicy(QObject *parent=nullptr);
+
+            /**
+             * @brief       Sets the time that a request must remain current before the page is prefetched.
+             *
+             * @param[in]   milliseconds the delay.
+             */
+            auto setDelay(int milliseconds) -> void;
+
+            /**
+             * @brief       Requests that a page is prefetched, replacing any pending request.
+             *
+             * @param[in]   page the index of the page.
+             * @param[in]   isLoaded true if the page has already been created.
+             */
+            auto request(int page, bool isLoaded) -> void;
+
+            /**
+             * @brief       Cancels the pending request, if any.
+             */
+            auto cancel() -> void;
+
+            /**
+             * @brief       Records that a page has been shown.
+             *
+             * @param[in]   page the index of the page.
+             * @param[in]   isLoaded true if the page had been created before it was shown.
+             */
+            auto shown(int page, bool isLoaded) -> void;
+
+            /**
+             * @brief       Returns the statistics of the policy.
+             *
+             * @returns     the statistics.
+             */
+            auto statistics() -> Statistics;
+
+            /**
+             * @brief       Emitted when a page should be prefetched.
+             *
+             * @param[in]   page the index of the page.
+             */
+            Q_SIGNAL void prefetch(int page);
+
+        private:
+            //! @cond
+
+            QTimer *m_timer;
+            int m_pendingPage;
+            QSet<int> m_prefetchedPages;
+            Statistics m_statistics;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_PREFETCHPOLICY_H
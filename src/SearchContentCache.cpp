@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SearchContentCache.h"
+
+#include <QAbstractButton>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QGroupBox>
+#include <QLabel>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTextDocument>
+#include <QTextDocumentFragment>
+#include <QWidget>
+
+constexpr quint32 CacheMagic = 0x4e534343;
+constexpr quint32 CacheFormatVersion = 1;
+constexpr auto CacheStreamVersion = QDataStream::Qt_5_12;
+constexpr auto CacheFileName = "SettingsDialog/SearchContent.cache";
+
+Nedrysoft::SettingsDialog::SearchContentCache::SearchContentCache() :
+        m_isModified(false) {
+
+}
+
+auto Nedrysoft::SettingsDialog::SearchContentCache::defaultFileName() -> QString {
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath(CacheFileName);
+}
+
+auto Nedrysoft::SettingsDialog::SearchContentCache::load(const QString &fileName) -> bool {
+    QFile file(fileName);
+
+    if (!file.open(QFile::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+
+    stream.setVersion(CacheStreamVersion);
+
+    quint32 magic = 0, formatVersion = 0, entryCount = 0;
+
+    stream >> magic >> formatVersion;
+
+    if ((magic!=CacheMagic) || (formatVersion!=CacheFormatVersion)) {
+        return false;
+    }
+
+    stream >> entryCount;
+
+    QMap<QString, Entry> entries;
+
+    for (quint32 entryIndex=0;entryIndex<entryCount;entryIndex++) {
+        QString identifier;
+        Entry entry;
+        quint32 itemCount = 0;
+
+        stream >> identifier >> entry.m_version >> itemCount;
+
+        for (quint32 itemIndex=0;itemIndex<itemCount;itemIndex++) {
+            SearchContentItem item;
+
+            stream >> item.m_text >> item.m_objectName;
+
+            entry.m_items.append(item);
+        }
+
+        if (stream.status()!=QDataStream::Ok) {
+            return false;
+        }
+
+        entries[identifier] = entry;
+    }
+
+    m_entries = entries;
+    m_isModified = false;
+
+    return true;
+}
+
+auto Nedrysoft::SettingsDialog::SearchContentCache::save(const QString &fileName) -> bool {
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+
+    QSaveFile file(fileName);
+
+    if (!file.open(QFile::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+
+    stream.setVersion(CacheStreamVersion);
+
+    stream << CacheMagic << CacheFormatVersion << static_cast<quint32>(m_entries.count());
+
+    for (auto entry=m_entries.constBegin();entry!=m_entries.constEnd();entry++) {
+        stream << entry.key() << entry->m_version << static_cast<quint32>(entry->m_items.count());
+
+        for (auto &item : entry->m_items) {
+            stream << item.m_text << item.m_objectName;
+        }
+    }
+
+    if (!file.commit()) {
+        return false;
+    }
+
+    m_isModified = false;
+
+    return true;
+}
+
+auto Nedrysoft::SettingsDialog::SearchContentCache::contains(
+        const QString &identifier,
+        const QString &version) -> bool {
+
+    auto entry = m_entries.constFind(identifier);
+
+    return (entry!=m_entries.constEnd()) && (entry->m_version==version);
+}
+
+auto Nedrysoft::SettingsDialog::SearchContentCache::content(
+        const QString &identifier) -> QList<Nedrysoft::SettingsDialog::SearchContentItem> {
+
+    return m_entries.value(identifier).m_items;
+}
+
+auto Nedrysoft::SettingsDialog::SearchContentCache::setContent(
+        const QString &identifier,
+        const QString &version,
+        const QList<SearchContentItem> &items) -> void {
+
+    Entry entry;
+
+    entry.m_version = version;
+    entry.m_items = items;
+
+    m_entries[identifier] = entry;
+
+    m_isModified = true;
+}
+
+auto Nedrysoft::SettingsDialog::SearchContentCache::isModified() -> bool {
+    return m_isModified;
+}
+
+auto Nedrysoft::SettingsDialog::SearchContentCache::crawl(
+        QWidget *widget) -> QList<Nedrysoft::SettingsDialog::SearchContentItem> {
+
+    QList<SearchContentItem> items;
+
+    auto addItem = [&items](QString text, QWidget *target) {
+        if (Qt::mightBeRichText(text)) {
+            text = QTextDocumentFragment::fromHtml(text).toPlainText();
+        }
+
+        text = text.remove(QChar('&')).simplified();
+
+        if (text.isEmpty()) {
+            return;
+        }
+
+        SearchContentItem item;
+
+        item.m_text = text;
+        item.m_objectName = target->objectName();
+
+        items.append(item);
+    };
+
+    auto widgets = widget->findChildren<QWidget *>();
+
+    widgets.prepend(widget);
+
+    for (auto childWidget : widgets) {
+        if (auto label = qobject_cast<QLabel *>(childWidget)) {
+            addItem(label->text(), label->buddy() ? label->buddy() : label);
+        } else if (auto button = qobject_cast<QAbstractButton *>(childWidget)) {
+            addItem(button->text(), button);
+        } else if (auto groupBox = qobject_cast<QGroupBox *>(childWidget)) {
+            addItem(groupBox->title(), groupBox);
+        }
+
+        addItem(childWidget->toolTip(), childWidget);
+    }
+
+    return items;
+}
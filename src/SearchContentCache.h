@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_SEARCHCONTENTCACHE_H
+#define NEDRYSOFT_SEARCHCONTENTCACHE_H
+
+#include <QList>
+#include <QMap>
+#include <QString>
+
+class QWidget;
+
+namespace Nedrysoft { namespace SettingsDialog {
+    /**
+     * @brief       The SearchContentItem class describes a piece of searchable text found within a page widget.
+     */
+    class SearchContentItem {
+        public:
+            //! @cond
+
+            QString m_text;
+            QString m_objectName;
+
+            //! @endcond
+    };
+
+    /**
+     * @brief       The SearchContentCache class stores the searchable text of page widgets.
+     *
+     * @details     The text of each page is gathered by crawling its widget tree once, the result is persisted
+     *              to a cache file keyed by the page identifier and version so that later sessions can search the
+     *              option text of a page without creating its widget.
+     */
+    class SearchContentCache {
+        public:
+            /**
+             * @brief       Constructs a new empty SearchContentCache.
+             */
+            SearchContentCache();
+
+            /**
+             * @brief       Returns the default location of the cache file.
+             *
+             * @returns     the file name.
+             */
+            static auto defaultFileName() -> QString;
+
+            /**
+             * @brief       Loads the cache from a file.
+             *
+             * @param[in]   fileName the file to load.
+             *
+             * @returns     true if the cache was loaded; otherwise false.
+             */
+            auto load(const QString &fileName) -> bool;
+
+            /**
+             * @brief       Saves the cache to a file.
+             *
+             * @param[in]   fileName the file to save to.
+             *
+             * @returns     true if the cache was saved; otherwise false.
+             */
+            auto save(const QString &fileName) -> bool;
+
+            /**
+             * @brief       Checks whether the cache holds content for a page.
+             *
+             * @param[in]   identifier the identifier of the page.
+             * @param[in]   version the version of the page.
+             *
+             * @returns     true if the cache holds content for this version of the page; otherwise false.
+             */
+            auto contains(const QString &identifier, const QString &version) -> bool;
+
+            /**
+             * @brief       Returns the cached content for a page.
+             *
+             * @param[in]   identifier the identifier of the page.
+             *
+             * @returns     the list of content items.
+             */
+            auto content(const QString &identifier) -> QList<SearchContentItem>;
+
+            /**
+             * @brief       Sets the content for a page.
+             *
+             * @param[in]   identifier the identifier of the page.
+             * @param[in]   version the version of the page.
+             * @param[in]   items the list of content items.
+             */
+            auto setContent(const QString &identifier, const QString &version, const QList<SearchContentItem> &items) -> void;
+
+            /**
+             * @brief       Returns whether the cache has been modified since it was loaded or saved.
+             *
+             * @returns     true if modified; otherwise false.
+             */
+            auto isModified() -> bool;
+
+            /**
+             * @brief       Gathers the searchable text from a widget and its children.
+             *
+             * @details     The text of labels, buttons (including check boxes and radio buttons), group boxes and
+             *              tool tips is gathered along with the object name of the widget that the text describes.
+             *
+             * @param[in]   widget the widget to crawl.
+             *
+             * @returns     the list of content items.
+             */
+            static auto crawl(QWidget *widget) -> QList<SearchContentItem>;
+
+        private:
+            //! @cond
+
+            struct Entry {
+                QString m_version;
+                QList<SearchContentItem> m_items;
+            };
+
+            QMap<QString, Entry> m_entries;
+            bool m_isModified;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_SEARCHCONTENTCACHE_H
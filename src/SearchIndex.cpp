@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SearchIndex.h"
+
+#include "FuzzyMatcher.h"
+
+#include <algorithm>
+#include <iterator>
+
+constexpr auto RootNode = 0;
+
+Nedrysoft::SettingsDialog::SearchIndex::SearchIndex() {
+    m_nodes.append(Node());
+}
+
+auto Nedrysoft::SettingsDialog::SearchIndex::addText(int document, const QString &text) -> void {
+    for (auto &word : tokenise(text)) {
+        auto currentNode = RootNode;
+
+        for (auto character : word) {
+            currentNode = child(currentNode, character, true);
+
+            auto &documents = m_nodes[currentNode].m_documents;
+
+            if (documents.isEmpty() || (documents.last()<document)) {
+                documents.append(document);
+            } else {
+                auto position = std::lower_bound(documents.begin(), documents.end(), document);
+
+                if (*position!=document) {
+                    documents.insert(position, document);
+                }
+            }
+        }
+    }
+
+    m_lastQuery.clear();
+}
+
+auto Nedrysoft::SettingsDialog::SearchIndex::clear() -> void {
+    m_nodes.clear();
+    m_nodes.append(Node());
+
+    m_lastQuery.clear();
+    m_lastTerms.clear();
+    m_lastResult.clear();
+}
+
+auto Nedrysoft::SettingsDialog::SearchIndex::find(const QString &query) -> QVector<int> {
+    auto terms = tokenise(query);
+
+    if (terms.isEmpty()) {
+        m_lastQuery.clear();
+
+        return QVector<int>();
+    }
+
+    // if the query extends the previous query then the result can only be a subset of the previous result, so
+    // only the terms that have changed need to be applied.
+
+    auto isNarrowing = (!m_lastQuery.isEmpty() && query.startsWith(m_lastQuery));
+    auto isFirstTerm = !isNarrowing;
+
+    QVector<int> result;
+
+    if (isNarrowing) {
+        result = m_lastResult;
+    }
+
+    for (auto &term : terms) {
+        if (isNarrowing && m_lastTerms.contains(term)) {
+            continue;
+        }
+
+        if (isFirstTerm) {
+            result = documents(term);
+
+            isFirstTerm = false;
+        } else {
+            result = intersect(result, documents(term));
+        }
+
+        if (result.isEmpty()) {
+            break;
+        }
+    }
+
+    m_lastQuery = query;
+    m_lastTerms = terms;
+    m_lastResult = result;
+
+    return result;
+}
+
+auto Nedrysoft::SettingsDialog::SearchIndex::tokenise(const QString &text) -> QStringList {
+    QStringList words;
+    QString word;
+
+    // the text is normalised in the same way as the text that the fuzzy matcher scores, so that the in-memory index
+    // and the mapped index built from normalised text match the same words.
+
+    for (auto character : FuzzyMatcher::normalise(text)) {
+        if (character.isLetterOrNumber()) {
+            word.append(character);
+        } else if (!word.isEmpty()) {
+            words.append(word);
+            word.clear();
+        }
+    }
+
+    if (!word.isEmpty()) {
+        words.append(word);
+    }
+
+    return words;
+}
+
+auto Nedrysoft::SettingsDialog::SearchIndex::child(int node, QChar character, bool create) -> int {
+    auto &children = m_nodes[node].m_children;
+
+    auto position = std::lower_bound(
+            children.begin(),
+            children.end(),
+            character,
+            [](const QPair<QChar, int> &child, QChar value) {
+                return child.first<value;
+            } );
+
+    if ((position!=children.end()) && (position->first==character)) {
+        return position->second;
+    }
+
+    if (!create) {
+        return -1;
+    }
+
+    auto childNode = static_cast<int>(m_nodes.count());
+
+    // the child is inserted before the node is appended, as appending may reallocate the node storage
+
+    children.insert(position, qMakePair(character, childNode));
+
+    m_nodes.append(Node());
+
+    return childNode;
+}
+
+auto Nedrysoft::SettingsDialog::SearchIndex::documents(const QString &prefix) -> QVector<int> {
+    auto currentNode = RootNode;
+
+    for (auto character : prefix) {
+        currentNode = child(currentNode, character, false);
+
+        if (currentNode==-1) {
+            return QVector<int>();
+        }
+    }
+
+    return m_nodes.at(currentNode).m_documents;
+}
+
+auto Nedrysoft::SettingsDialog::SearchIndex::intersect(
+        const QVector<int> &left,
+        const QVector<int> &right) -> QVector<int> {
+
+    QVector<int> result;
+
+    result.reserve(qMin(left.count(), right.count()));
+
+    std::set_intersection(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(result));
+
+    return result;
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_SEARCHINDEX_H
+#define NEDRYSOFT_SEARCHINDEX_H
+
+#include <QChar>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace Nedrysoft { namespace SettingsDialog {
+    /**
+     * @brief       The SearchIndex class provides an in-memory prefix index over text documents.
+     *
+     * @details     Each word of a document is inserted into a trie, every node of the trie holds the sorted list
+     *              of documents that contain a word beginning with the prefix that the node represents.  A query
+     *              is resolved by walking one node per character and intersecting the lists of each query term,
+     *              when a query extends the previous query only the previous results are narrowed.
+     */
+    class SearchIndex {
+        public:
+            /**
+             * @brief       Constructs a new empty SearchIndex.
+             */
+            SearchIndex();
+
+            /**
+             * @brief       Adds text to a document in the index.
+             *
+             * @note        Text may be added to a document multiple times, documents are expected to be added in
+             *              increasing identifier order although this is not required.
+             *
+             * @param[in]   document the identifier of the document.
+             * @param[in]   text the text to be indexed.
+             */
+            auto addText(int document, const QString &text) -> void;
+
+            /**
+             * @brief       Removes all documents from the index.
+             */
+            auto clear() -> void;
+
+            /**
+             * @brief       Finds the documents that match a query.
+             *
+             * @details     A document matches if every term in the query is a prefix of a word in the document.
+             *
+             * @param[in]   query the text to search for.
+             *
+             * @returns     the sorted list of matching document identifiers.
+             */
+            auto find(const QString &query) -> QVector<int>;
+
+            /**
+             * @brief       Splits text into normalised words.
+             *
+             * @details     The text is normalised with FuzzyMatcher::normalise(), so words are case folded and
+             *              accented characters match their unaccented form.
+             *
+             * @param[in]   text the text to split.
+             *
+             * @returns     the list of words.
+             */
+            static auto tokenise(const QString &text) -> QStringList;
+
+        private:
+            /**
+             * @brief       Returns the child of a node for a character.
+             *
+             * @param[in]   node the index of the parent node.
+             * @param[in]   character the normalised character.
+             * @param[in]   create true if a missing child should be created; otherwise false.
+             *
+             * @returns     the index of the child node if found; otherwise -1.
+             */
+            auto child(int node, QChar character, bool create) -> int;
+
+            /**
+             * @brief       Returns the documents that contain a word beginning with the given prefix.
+             *
+             * @param[in]   prefix the normalised prefix.
+             *
+             * @returns     the sorted list of document identifiers.
+             */
+            auto documents(const QString &prefix) -> QVector<int>;
+
+            /**
+             * @brief       Returns the intersection of two sorted lists.
+             *
+             * @param[in]   left the first list.
+             * @param[in]   right the second list.
+             *
+             * @returns     the items that appear in both lists.
+             */
+            static auto intersect(const QVector<int> &left, const QVector<int> &right) -> QVector<int>;
+
+        private:
+            //! @cond
+
+            struct Node {
+                QVector<QPair<QChar, int> > m_children;
+                QVector<int> m_documents;
+            };
+
+            QVector<Node> m_nodes;
+
+            QString m_lastQuery;
+            QStringList m_lastTerms;
+            QVector<int> m_lastResult;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_SEARCHINDEX_H
@@ -23,18 +23,37 @@
 
 #include "SettingsDialog.h"
 
+#include "ApplyPipeline.h"
+#include "ConstraintRegistry.h"
+#include "FuzzyMatcher.h"
 #include "ISettingsPage.h"
+#include "MappedSearchIndex.h"
+#include "SearchContentCache.h"
+#include "SearchIndex.h"
 #include "SeparatorWidget.h"
+#include "SettingsJournal.h"
+#include "SettingsSchema.h"
+#include "SettingsSnapshot.h"
+#include "SettingsStore.h"
+#include "ValidationCache.h"
 #if defined(Q_OS_MACOS)
 #include "TransparentWidget.h"
 #endif
 
 #include <QApplication>
+#include <QHash>
+#include <QPair>
 #include <QResizeEvent>
 #include <QScreen>
+#include <QScrollArea>
+#include <QSet>
+#include <QShortcut>
+#include <QTimer>
 #include <QTreeWidget>
+#include <QVector>
 #include <QVBoxLayout>
 #include <ThemeSupport>
+#include <algorithm>
 
 #if defined(Q_OS_MACOS)
 #include <MacToolbar>
@@ -45,9 +64,16 @@
 #include <QPropertyAnimation>
 #include <memory>
 #else
+#include <QBrush>
 #include <QLabel>
+#include <QLineEdit>
+#include <QProgressBar>
 #include <QPushButton>
+#include <QSignalBlocker>
 #include <QStackedWidget>
+#include <QStyle>
+#include <QTabBar>
+#include <QTabWidget>
 #endif
 
 #if defined(Q_OS_MACOS)
@@ -67,6 +93,11 @@ constexpr auto CategoryBottomMargin = 9;
 constexpr auto DetailsLeftMargin = 9;
 #endif
 
+constexpr auto LiveApplyDelay = 300;
+#if !defined(Q_OS_MACOS)
+constexpr auto SearchIndexDelay = 100;
+#endif
+
 constexpr auto ThemeStylesheet = R"(
     QStackedWidget {
         [base-background-colour];
@@ -91,10 +122,8 @@ constexpr auto ThemeStylesheet = R"(
     QTabBar::tab:!selected {
         [base-background-colour];
     }
-)";
 
-constexpr auto ThemeSubStylesheet = R"(
-    QStackedWidget {
+    QTabWidget QStackedWidget {
         [background-colour];
     }
 )";
@@ -132,6 +161,34 @@ Nedrysoft::SettingsDialog::SettingsDialog::SettingsDialog(const QList<Nedrysoft:
 
     setStyleSheet(updateStyleSheet(ThemeStylesheet, themeSupport->isDarkMode()));
 
+    m_isLiveApply = false;
+
+    m_settingsSnapshot = new SettingsSnapshot;
+    m_constraintRegistry = new ConstraintRegistry(this);
+    m_validationCache = new ValidationCache(this);
+
+    m_validationCache->setConstraintRegistry(m_constraintRegistry);
+
+#if !defined(Q_OS_MACOS)
+    connect(m_validationCache, &ValidationCache::validityChanged, [=](ISettingsPage *page, bool isValid) {
+        markPageValidity(page, isValid);
+    });
+#endif
+
+    m_journal = new SettingsJournal;
+    m_isReplayingJournal = false;
+
+    auto undoShortcut = new QShortcut(QKeySequence::Undo, this);
+    auto redoShortcut = new QShortcut(QKeySequence::Redo, this);
+
+    connect(undoShortcut, &QShortcut::activated, [=]() {
+        undo();
+    });
+
+    connect(redoShortcut, &QShortcut::activated, [=]() {
+        redo();
+    });
+
 #if defined(Q_OS_MACOS)
     m_toolbar = new Nedrysoft::MacHelper::MacToolbar;
 
@@ -141,6 +198,53 @@ Nedrysoft::SettingsDialog::SettingsDialog::SettingsDialog(const QList<Nedrysoft:
 
     m_mainLayout = new QHBoxLayout;
 
+    m_searchIndex = new SearchIndex;
+
+    m_searchEdit = new QLineEdit;
+
+    m_searchEdit->setPlaceholderText(tr("Search"));
+    m_searchEdit->setClearButtonEnabled(true);
+
+    connect(m_searchEdit, &QLineEdit::textChanged, [=](const QString &text) {
+        updateSearchResults(text);
+    });
+
+    connect(m_searchEdit, &QLineEdit::returnPressed, [=]() {
+        if (!m_searchResults.isEmpty()) {
+            showPage(m_pages.at(m_searchResults.first()));
+        }
+    });
+
+    // the content of pages that are not in the cache is gathered one page at a time when the event loop is idle
+
+    m_mappedIndex = new MappedSearchIndex;
+    m_searchIndexKey = 0;
+    m_contentIndexCount = 0;
+    m_deferredContentCount = 0;
+    m_isBackgroundCrawl = false;
+
+    m_contentCache = new SearchContentCache;
+    m_isContentCacheLoaded = false;
+
+    m_contentTimer = new QTimer(this);
+
+    m_contentTimer->setInterval(0);
+
+    connect(m_contentTimer, &QTimer::timeout, [=]() {
+        crawlNextPageContent();
+    });
+
+    // pages delivered in several batches, such as by SettingsPageLoader, are indexed once the last batch arrives
+
+    m_searchIndexTimer = new QTimer(this);
+
+    m_searchIndexTimer->setSingleShot(true);
+    m_searchIndexTimer->setInterval(SearchIndexDelay);
+
+    connect(m_searchIndexTimer, &QTimer::timeout, [=]() {
+        updateSearchIndex();
+    });
+
     m_treeWidget = new QTreeWidget(this);
 
     m_treeWidget->setIndentation(0);
@@ -153,13 +257,70 @@ Nedrysoft::SettingsDialog::SettingsDialog::SettingsDialog(const QList<Nedrysoft:
 
     m_treeWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 
+    // the page under the pointer is prefetched so that it is usually ready by the time that it is clicked
+
+    m_prefetchPolicy = new PrefetchPolicy(this);
+
+    connect(m_prefetchPolicy, &PrefetchPolicy::prefetch, [=](int page) {
+        prefetchPage(m_pages.at(page));
+    });
+
+    m_treeWidget->setMouseTracking(true);
+    m_treeWidget->viewport()->installEventFilter(this);
+
+    connect(m_treeWidget, &QTreeWidget::itemEntered, [=](QTreeWidgetItem *item, int column) {
+        Q_UNUSED(column)
+
+        auto section = m_sectionItems.value(item);
+
+        if (!section || (item==m_treeWidget->currentItem())) {
+            m_prefetchPolicy->cancel();
+
+            return;
+        }
+
+        auto settingsPage = sectionPage(section);
+
+        m_prefetchPolicy->request(settingsPage->m_document, settingsPage->m_widget!=nullptr);
+    });
+
+    connect(m_treeWidget, &QTreeWidget::viewportEntered, [=]() {
+        m_prefetchPolicy->cancel();
+    });
+
     m_stackedWidget = new QStackedWidget;
 
     m_stackedWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 
     m_stackedWidget->layout()->setContentsMargins(0, 0, 0, 0);
 
-    m_mainLayout->addWidget(m_treeWidget);
+    m_navigationLayout = new QVBoxLayout;
+
+    m_navigationLayout->addWidget(m_searchEdit);
+    m_navigationLayout->addWidget(m_treeWidget);
+
+    m_mainLayout->addLayout(m_navigationLayout);
+
+    connect(m_treeWidget, &QTreeWidget::currentItemChanged, [=](QTreeWidgetItem *current, QTreeWidgetItem *previous) {
+        Q_UNUSED(previous)
+
+        if (!current) {
+            return;
+        }
+
+        auto section = m_sectionItems.value(current);
+
+        if (section) {
+            // sections are built the first time that they are shown
+
+            loadShownPage(sectionPage(section));
+
+            m_stackedWidget->setCurrentWidget(section->m_widget);
+            m_categoryLabel->setText(current->text(0));
+
+            updateVisiblePages();
+        }
+    });
 
     m_categoryLabel = new QLabel;
 
@@ -188,6 +349,29 @@ Nedrysoft::SettingsDialog::SettingsDialog::SettingsDialog(const QList<Nedrysoft:
 
     m_controlsLayout = new QHBoxLayout;
 
+    // the settings are applied by a pipeline so that slow pages do not block the dialog, the progress bar is only
+    // shown while the pipeline is running.
+
+    m_applyPipeline = new ApplyPipeline(this);
+    m_isClosingAfterApply = false;
+    m_hasPendingChanges = false;
+
+    m_progressBar = new QProgressBar;
+
+    m_progressBar->setTextVisible(false);
+    m_progressBar->setVisible(false);
+
+    connect(m_applyPipeline, &ApplyPipeline::progressChanged, [=](int value, int maximum) {
+        m_progressBar->setRange(0, maximum);
+        m_progressBar->setValue(value);
+    });
+
+    connect(m_applyPipeline, &ApplyPipeline::finished, [=](bool isApplied) {
+        applyFinished(isApplied);
+    });
+
+    m_controlsLayout->addWidget(m_progressBar);
+
     m_controlsLayout->addSpacerItem(new QSpacerItem(0,0,QSizePolicy::Expanding, QSizePolicy::Minimum));
 
     m_okButton = new QPushButton(tr("OK"));
@@ -197,8 +381,23 @@ Nedrysoft::SettingsDialog::SettingsDialog::SettingsDialog(const QList<Nedrysoft:
     m_applyButton->setDisabled(true);
 
     connect(m_okButton, &QPushButton::clicked, [=](bool /*checked*/) {
-        acceptSettings();
-        close();
+        // in live apply mode the changes have already been applied, any that are still pending are applied when
+        // the dialog closes.
+
+        if (m_isLiveApply) {
+            close();
+
+            return;
+        }
+
+        // the dialog is closed once the pipeline has finished applying the settings, which may be immediately if
+        // nothing has changed.
+
+        m_isClosingAfterApply = true;
+
+        if (acceptSettings()!=AcceptStatus::Started) {
+            m_isClosingAfterApply = false;
+        }
     });
 
     connect(m_applyButton, &QPushButton::clicked, [=](bool /*checked*/) {
@@ -206,6 +405,14 @@ Nedrysoft::SettingsDialog::SettingsDialog::SettingsDialog(const QList<Nedrysoft:
     });
 
     connect(m_cancelButton, &QPushButton::clicked, [=](bool /*checked*/) {
+        if (m_applyPipeline->isRunning()) {
+            m_applyPipeline->cancel();
+
+            m_cancelButton->setDisabled(true);
+
+            return;
+        }
+
         close();
     });
 
@@ -218,45 +425,12 @@ Nedrysoft::SettingsDialog::SettingsDialog::SettingsDialog(const QList<Nedrysoft:
     setLayout(m_layout);
 #endif
 
-    for (auto page: pages) {
-#if defined(Q_OS_MACOS)
-        auto settingsPage = addPage(page);
-
-        m_pages[settingsPage->m_toolbarItem] = settingsPage;
-#else
-        connect(page, &Nedrysoft::SettingsDialog::ISettingsPage::settingsChanged, [=]() {
-            m_applyButton->setDisabled(false);
-        });
-
-        auto settingsPage = addPage(page);
-
-        m_pages.append(settingsPage);
-#endif
-    }
+    addPages(pages);
 
 #if defined(Q_OS_MACOS)
     m_toolbar->enablePreferencesToolbar();
 #endif
 
-#if !defined(Q_OS_MACOS)
-    int listWidth = 0;
-
-    for (auto currentIndex=0;currentIndex<m_treeWidget->topLevelItemCount();currentIndex++) {
-        auto item = m_treeWidget->topLevelItem(currentIndex);
-
-        auto fontMetrics = QFontMetrics(m_treeWidget->font());
-
-        auto width = fontMetrics.boundingRect(item->text(0)).width();
-
-        if (width>listWidth) {
-            listWidth = width;
-        }
-    }
-
-    m_treeWidget->setMinimumWidth(listWidth+(SettingsIconSize*2));
-    m_treeWidget->setMaximumWidth(listWidth+(SettingsIconSize*2));
-#endif
-
 #if defined(Q_OS_MACOS)
     m_toolbar->attachToWindow(this);
 
@@ -305,371 +479,1892 @@ Nedrysoft::SettingsDialog::SettingsDialog::SettingsDialog(const QList<Nedrysoft:
 #endif
 }
 
-auto Nedrysoft::SettingsDialog::SettingsDialog::updateTitlebar() -> void {
-#if defined(Q_OS_MACOS)
-    Nedrysoft::MacHelper::MacHelper macHelper;
-
-    auto themeSupport = Nedrysoft::ThemeSupport::ThemeSupport::getInstance();
-
-    if (themeSupport->isForced()) {
-        QColor colour;
+auto Nedrysoft::SettingsDialog::SettingsDialog::addPages(const QList<ISettingsPage *> &pages) -> void {
+    QList<SettingsPageDescriptor> descriptors;
 
-        if (themeSupport->isDarkMode()) {
-            colour = QColor::fromRgbF(0.23, 0.22, 0.23);
-        } else {
-            colour = QColor::fromRgbF(0.91, 0.90, 0.91);
-        }
-        
-        macHelper.setTitlebarColour(
-                this,
-                colour,
-                themeSupport->isDarkMode()
-        );
-    } else {
-        macHelper.clearTitlebarColour(this, themeSupport->isDarkMode());
-    }
-#endif
-}
+    descriptors.reserve(pages.count());
 
-auto Nedrysoft::SettingsDialog::SettingsDialog::sizeHint() -> QSize {
-    if (m_currentPage) {
-        return m_currentPage->m_widget->sizeHint();
+    for (auto page : pages) {
+        descriptors.append(SettingsPageDescriptor(page));
     }
 
-    return QWidget::sizeHint();
+    insertPages(descriptors, pages, SettingsPageResolver());
 }
 
-Nedrysoft::SettingsDialog::SettingsDialog::~SettingsDialog() {
+auto Nedrysoft::SettingsDialog::SettingsDialog::addPages(
+        const QList<SettingsPageDescriptor> &descriptors,
+        const SettingsPageResolver &resolver) -> void {
+
 #if defined(Q_OS_MACOS)
-    delete m_toolbar;
-#else
-    for (auto page : m_pages) {
-        disconnect(page->m_pageSettings, 0, 0, 0);
+    // the toolbar and window size are derived from the page widgets, so every page is created up front
 
-        delete page;
-    }
-    delete m_layout;
-    delete m_treeWidget;
-    delete m_categoryLabel;
-    delete m_stackedWidget;
-#endif
-}
+    QList<ISettingsPage *> pages;
 
-auto Nedrysoft::SettingsDialog::SettingsDialog::okToClose() -> bool {
-#if !defined(Q_OS_MACOS)
-    for(auto page : m_pages) {
-        if (!page->m_pageSettings->canAcceptSettings()) {
+    for (auto &descriptor : descriptors) {
+        auto page = resolver(descriptor);
 
-            return false;
+        if (page) {
+            pages.append(page);
         }
     }
+
+    addPages(pages);
+#else
+    insertPages(descriptors, QList<ISettingsPage *>(), resolver);
 #endif
-    return true;
 }
 
-auto Nedrysoft::SettingsDialog::SettingsDialog::resizeEvent(QResizeEvent *event) -> void {
-    for(auto page : m_pages) {
-        if (page->m_widget) {
-#if defined(Q_OS_MACOS)
-            page->m_widget->resize((event->size()));
-#else
-            // resizing needs to account for the category label & margins
+auto Nedrysoft::SettingsDialog::SettingsDialog::insertPages(
+        const QList<SettingsPageDescriptor> &descriptors,
+        const QList<ISettingsPage *> &pages,
+        const SettingsPageResolver &resolver) -> void {
 
-            auto margins = m_layout->contentsMargins();
+    struct PageOrder {
+        int index;
+        int section;
+        int category;
+        int weight;
+    };
 
-            auto adjustment = margins.bottom()+m_categoryLabel->height()+m_layout->spacing();
+    QList<PageOrder> orderedPages;
+    QHash<QString, int> sections;
+    QHash<QPair<QString, QString>, int> categories;
+    QVector<int> sectionWeights;
+    QVector<int> categoryWeights;
 
-            page->m_widget->resize(m_stackedWidget->size()-QSize(margins.right(), adjustment));
-#endif
-        }
-    }
-}
+    orderedPages.reserve(descriptors.count());
 
-auto Nedrysoft::SettingsDialog::SettingsDialog::nativeWindowHandle() -> QWindow * {
-    //
-    // @note the call to winId() is required as it sets up windowHandle() to return the correct value,
-    //       failing to call this will result in windowHandle not returning the correct value.
+    // group the pages by section and category in a single pass, the weight of a section or category is the
+    // lowest weight of any page that it contains.
 
-    window()->winId();
+    for (auto index=0;index<descriptors.count();index++) {
+        auto &descriptor = descriptors.at(index);
+        auto sectionName = descriptor.m_section;
+        auto categoryKey = qMakePair(sectionName, descriptor.m_category);
+        auto weight = descriptor.m_weight;
 
-    return window()->windowHandle();
-}
+        auto section = sections.value(sectionName, -1);
 
-auto Nedrysoft::SettingsDialog::SettingsDialog::addPage(ISettingsPage *page) -> Nedrysoft::SettingsDialog::SettingsPage * {
-    auto themeSupport = Nedrysoft::ThemeSupport::ThemeSupport::getInstance();
+        if (section==-1) {
+            section = sectionWeights.count();
 
-#if defined(Q_OS_MACOS)
-    TransparentWidget *widgetContainer = nullptr;
-    SettingsPage *settingsPage = nullptr;
+            sections[sectionName] = section;
+            sectionWeights.append(weight);
+        } else {
+            sectionWeights[section] = qMin(sectionWeights[section], weight);
+        }
 
-    for(auto currentPage : m_pages) {
-        if (currentPage->m_name==page->section()) {
-            widgetContainer = currentPage->m_widget;
-            settingsPage = currentPage;
+        auto category = categories.value(categoryKey, -1);
 
-            break;
+        if (category==-1) {
+            category = categoryWeights.count();
+
+            categories[categoryKey] = category;
+            categoryWeights.append(weight);
+        } else {
+            categoryWeights[category] = qMin(categoryWeights[category], weight);
         }
-    }
 
-    if (!widgetContainer) {
-        widgetContainer = new TransparentWidget(0, this);
+        orderedPages.append(PageOrder{index, section, category, weight});
     }
 
-    if (widgetContainer->count()) {
-        widgetContainer->addWidget(new SeparatorWidget);
-    }
+    std::stable_sort(orderedPages.begin(), orderedPages.end(), [&](const PageOrder &left, const PageOrder &right) {
+        if (left.section!=right.section) {
+            if (sectionWeights[left.section]!=sectionWeights[right.section]) {
+                return sectionWeights[left.section]<sectionWeights[right.section];
+            }
 
-    auto pageWidget = page->createWidget();
+            return left.section<right.section;
+        }
 
-    widgetContainer->addWidget(pageWidget);
+        if (left.category!=right.category) {
+            if (categoryWeights[left.category]!=categoryWeights[right.category]) {
+                return categoryWeights[left.category]<categoryWeights[right.category];
+            }
 
-    if (settingsPage) {
-#if defined(Q_OS_MACOS)
-        settingsPage->m_pageSettings.append(page);
-#endif
-        return settingsPage;
-    }
+            return left.category<right.category;
+        }
 
-    settingsPage = new SettingsPage;
+        return left.weight<right.weight;
+    });
 
-    settingsPage->m_name = page->section();
-    settingsPage->m_widget = widgetContainer;
-#if defined(Q_OS_MACOS)
-    settingsPage->m_pageSettings.append(page);
-#else
-    settingsPage->m_pageSettings = page;
-#endif
-    settingsPage->m_icon = page->icon(themeSupport->isDarkMode());
-    settingsPage->m_description = page->description();
+    auto updatesEnabled = this->updatesEnabled();
 
-    if (pageWidget->layout()) {
-        pageWidget->layout()->setSizeConstraint(QLayout::SetMinimumSize);
-    }
+    setUpdatesEnabled(false);
 
-    settingsPage->m_toolbarItem = m_toolbar->addItem(
-            page->icon(themeSupport->isDarkMode()),
-            page->section());
+    for (auto &orderedPage : orderedPages) {
+        addPage(descriptors.at(orderedPage.index), pages.value(orderedPage.index, nullptr), resolver);
+    }
 
-    connect(settingsPage->m_toolbarItem,
-            &Nedrysoft::MacHelper::MacToolbarItem::activated,
-            this,
-            [this, settingsPage]() {
+#if !defined(Q_OS_MACOS)
+    updateNavigationWidth();
 
-        if (!m_currentPage) {
-            m_currentPage = settingsPage;
-            m_currentPage->m_widget->setOpacity(1);
+    m_searchIndexTimer->start();
+#endif
 
-            resize(m_currentPage->m_widget->sizeHint());
+    setUpdatesEnabled(updatesEnabled);
+}
 
-            this->setWindowTitle(settingsPage->m_name);
+#if !defined(Q_OS_MACOS)
+auto Nedrysoft::SettingsDialog::SettingsDialog::updateNavigationWidth() -> void {
+    auto fontMetrics = QFontMetrics(m_treeWidget->font());
+    int listWidth = 0;
 
-            return;
-        }
+    for (auto currentIndex=0;currentIndex<m_treeWidget->topLevelItemCount();currentIndex++) {
+        auto item = m_treeWidget->topLevelItem(currentIndex);
 
-        auto currentItem = m_pages[m_currentPage->m_toolbarItem]->m_widget;
-        auto nextItem = settingsPage->m_widget;
+        auto width = fontMetrics.boundingRect(item->text(0)).width();
 
-        if (currentItem==nextItem) {
-            return;
+        if (width>listWidth) {
+            listWidth = width;
         }
+    }
 
-        if (m_animationGroup) {
-            m_animationGroup->stop();
-            m_animationGroup->deleteLater();
-        }
+    m_treeWidget->setMinimumWidth(listWidth+(SettingsIconSize*2));
+    m_treeWidget->setMaximumWidth(listWidth+(SettingsIconSize*2));
 
-        m_animationGroup = new QParallelAnimationGroup;
+    m_searchEdit->setMaximumWidth(listWidth+(SettingsIconSize*2));
+}
 
-        auto minSize = QSize(m_maximumWidth, nextItem->sizeHint().height());
+auto Nedrysoft::SettingsDialog::SettingsDialog::updateSearchIndex() -> void {
+    QStringList pageKeys;
 
-        auto propertyNames = {"size", "minimumSize", "maximumSize"};
+    // the key covers the indexed text of each page as well as its version, so a page whose name, description or
+    // keywords change without a new version does not map an index built from the old text.
 
-        for(auto property : propertyNames) {
-            auto sizeAnimation = new QPropertyAnimation(this, property);
+    for (auto settingsPage : m_pages) {
+        pageKeys << settingsPage->m_descriptor.m_identifier << settingsPage->m_descriptor.m_version;
 
-            sizeAnimation->setDuration(TransisionDuration.count());
-            sizeAnimation->setStartValue(currentItem->size());
-            sizeAnimation->setEndValue(minSize);
+        for (auto field=0;field<FuzzyMatcher::Content;field++) {
+            pageKeys << settingsPage->m_searchText.at(field);
+        }
+    }
+
+    m_searchIndexKey = MappedSearchIndex::key(pageKeys);
+
+    // the content text of each page refers directly to the mapped file, so it must be released before the file
+    // is closed.
 
-            m_animationGroup->addAnimation(sizeAnimation);
+    if (m_mappedIndex->isOpen()) {
+        for (auto settingsPage : m_pages) {
+            settingsPage->m_searchText[FuzzyMatcher::Content] = QString();
         }
 
-        auto outgoingAnimation = new QPropertyAnimation(currentItem->transparencyEffect(), "opacity");
+        m_mappedIndex->close();
+    }
 
-        outgoingAnimation->setDuration(TransisionDuration.count());
-        outgoingAnimation->setStartValue(currentItem->transparencyEffect()->opacity());
-        outgoingAnimation->setEndValue(AlphaTransparent);
+    if (m_mappedIndex->open(MappedSearchIndex::defaultFileName(), m_searchIndexKey)) {
+        if (m_mappedIndex->documentCount()==m_pages.count()) {
+            for (auto document=0;document<m_pages.count();document++) {
+                m_pages.at(document)->m_searchText[FuzzyMatcher::Content] = m_mappedIndex->text(document);
+            }
 
-        m_animationGroup->addAnimation(outgoingAnimation);
+            m_contentIndexCount = 0;
 
-        auto incomingAnimation = new QPropertyAnimation(nextItem->transparencyEffect(), "opacity");
+            return;
+        }
 
-        incomingAnimation->setDuration(TransisionDuration.count());
-        incomingAnimation->setStartValue(nextItem->transparencyEffect()->opacity());
-        incomingAnimation->setEndValue(AlphaOpaque);
+        m_mappedIndex->close();
+    }
 
-        m_animationGroup->addAnimation(incomingAnimation);
+    // the index file does not match the current set of pages, the content of the pages is gathered from the
+    // content cache or by crawling and the index file is rebuilt once all pages have been indexed.
 
-        m_animationGroup->start(QParallelAnimationGroup::DeleteWhenStopped);
+    if (!m_isContentCacheLoaded) {
+        m_contentCache->load(SearchContentCache::defaultFileName());
 
-        // the current page is set here immediately, so that if the page is changed again before the animation is
-        // complete then the new selection will be animated in from the current position in the previous animation
+        m_isContentCacheLoaded = true;
+    }
 
-        m_currentPage = settingsPage;
+    while (m_contentIndexCount<m_pages.count()) {
+        indexPageContent(m_pages.at(m_contentIndexCount++));
+    }
 
-        connect(m_animationGroup, &QParallelAnimationGroup::finished, [this, settingsPage]() {
-            m_animationGroup->deleteLater();
+    if (m_pendingContent.isEmpty()) {
+        writeSearchIndex();
+    }
+}
 
-            m_animationGroup = nullptr;
+auto Nedrysoft::SettingsDialog::SettingsDialog::writeSearchIndex() -> void {
+    // the index is keyed by the set of pages, so it is not written until the content of every page is known and
+    // the key has been updated for the latest pages
 
-            this->setWindowTitle(settingsPage->m_name);
-        });
-    });
+    if (m_deferredContentCount || m_searchIndexTimer->isActive()) {
+        return;
+    }
 
-    return settingsPage;
-#else
-    QTabWidget *tabWidget = nullptr;
+    QVector<QStringList> documents;
+
+    documents.reserve(m_pages.count());
 
-    for (int currentItem=0;currentItem<m_treeWidget->topLevelItemCount();currentItem++) {
-        QString itemSection = m_treeWidget->topLevelItem(currentItem)->text(0);
+    for (auto settingsPage : m_pages) {
+        documents.append(settingsPage->m_searchText);
+    }
+
+    MappedSearchIndex::write(MappedSearchIndex::defaultFileName(), m_searchIndexKey, documents);
+}
 
-        if (page->section()==itemSection) {
-            tabWidget = m_treeWidget->topLevelItem(currentItem)->data(0, Qt::UserRole).value<QTabWidget *>();
+auto Nedrysoft::SettingsDialog::SettingsDialog::rankedPages(const QString &text) -> QVector<int> {
+    FuzzyMatcher matcher(text);
+    QVector<QPair<int, int> > scoredDocuments;
 
-            break;
+    auto documents = m_mappedIndex->isOpen() ? m_mappedIndex->find(text) : m_searchIndex->find(text);
+
+    if (!documents.isEmpty()) {
+        // a multi-term prefix match may not form a single subsequence, such pages are kept with the lowest score
+
+        for (auto document : documents) {
+            auto score = qMax(matcher.scoreFields(m_pages.at(document)->m_searchText), 0);
+
+            scoredDocuments.append(qMakePair(score, document));
+        }
+    } else if (!matcher.isEmpty()) {
+        // the prefix index has no matches, so the pages are fuzzy matched so that misspelt searches still find
+        // results.  The score of each page is kept, so each page is only matched once.
+
+        for (auto document=0;document<m_pages.count();document++) {
+            auto score = matcher.scoreFields(m_pages.at(document)->m_searchText);
+
+            if (score>=0) {
+                scoredDocuments.append(qMakePair(score, document));
+            }
         }
     }
 
-    if (!tabWidget) {
-        auto treeItem = new QTreeWidgetItem(m_treeWidget);
+    std::stable_sort(
+            scoredDocuments.begin(),
+            scoredDocuments.end(),
+            [](const QPair<int, int> &left, const QPair<int, int> &right) {
+                return left.first>right.first;
+            } );
+
+    documents.clear();
+
+    documents.reserve(scoredDocuments.count());
+
+    for (auto &scoredDocument : scoredDocuments) {
+        documents.append(scoredDocument.second);
+    }
+
+    return documents;
+}
 
-        tabWidget = new QTabWidget();
+auto Nedrysoft::SettingsDialog::SettingsDialog::updateSearchResults(const QString &text) -> void {
+    // a search made before the index has been updated for the latest pages brings the index up to date first
 
-        treeItem->setIcon(0, page->icon(themeSupport->isDarkMode()));
-        treeItem->setText(0, page->section());
-        treeItem->setData(0, Qt::UserRole, QVariant::fromValue(tabWidget));
-        treeItem->setData(0, Qt::ToolTipRole, page->description());
+    if (m_searchIndexTimer->isActive()) {
+        m_searchIndexTimer->stop();
 
-        auto themeSupport = Nedrysoft::ThemeSupport::ThemeSupport::getInstance();
+        updateSearchIndex();
+    }
 
-        tabWidget->setStyleSheet(updateStyleSheet(ThemeSubStylesheet, themeSupport->isDarkMode()));
+    // the pages are ranked once for each change of the search text, the result is shared by the navigation
+    // filter, the prefetch and the return key.
 
-        auto signal = connect(
-            themeSupport,
-            &Nedrysoft::ThemeSupport::ThemeSupport::themeChanged,
-            [=](bool isDarkMode) {
+    if (SearchIndex::tokenise(text).isEmpty()) {
+        m_searchResults.clear();
 
-                auto themeSupport = Nedrysoft::ThemeSupport::ThemeSupport::getInstance();
+        filterNavigation(QString());
 
-                treeItem->setIcon(0, page->icon(themeSupport->isDarkMode()));
+        m_prefetchPolicy->cancel();
 
-                tabWidget->setStyleSheet(updateStyleSheet(ThemeSubStylesheet, themeSupport->isDarkMode()));
-            }
-        );
+        return;
+    }
 
-        connect(this, &QObject::destroyed, [themeSupport, signal]() {
-            themeSupport->disconnect(signal);
-        });
+    m_searchResults = rankedPages(text);
 
-        m_treeWidget->addTopLevelItem(treeItem);
+    filterNavigation(text);
 
-        connect(m_treeWidget, &QTreeWidget::currentItemChanged, [=](QTreeWidgetItem *current, QTreeWidgetItem *previous) {
-            Q_UNUSED(previous)
+    // the best result is the page that return opens, it is prefetched once the user pauses typing
 
-            auto widget = current->data(0, Qt::UserRole).value<QWidget *>();
+    if (m_searchResults.isEmpty()) {
+        m_prefetchPolicy->cancel();
+    } else {
+        auto settingsPage = m_pages.at(m_searchResults.first());
+
+        m_prefetchPolicy->request(settingsPage->m_document, settingsPage->m_widget!=nullptr);
+    }
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::indexPageContent(SettingsPage *settingsPage) -> void {
+    auto identifier = settingsPage->m_descriptor.m_identifier;
+
+    if (m_contentCache->contains(identifier, settingsPage->m_descriptor.m_version)) {
+        setPageContent(settingsPage, m_contentCache->content(identifier));
+
+        return;
+    }
 
-            if (widget) {
-                m_stackedWidget->setCurrentWidget(widget);
-                m_categoryLabel->setText(current->text(0));
+    // a page that provides its option text is indexed directly, otherwise only a widget owned by the dialog is
+    // crawled.  Creating a page widget only to crawl it would run the page constructor and any side effects that
+    // it has, so the page is crawled once it has been shown.
+
+    auto page = settingsPage->m_pageSettings;
+
+    if (page) {
+        auto text = page->searchText();
+
+        if (!text.isEmpty()) {
+            QList<SearchContentItem> items;
+
+            for (auto &line : text) {
+                SearchContentItem item;
+
+                item.m_text = line;
+
+                items.append(item);
             }
-        });
+
+            m_contentCache->setContent(page->identifier(), page->version(), items);
+
+            setPageContent(settingsPage, items);
+
+            return;
+        }
     }
 
-    auto widget = new QWidget;
-    auto widgetLayout = new QVBoxLayout;
-    auto pageWidget = page->createWidget();
+    if (!settingsPage->m_widget && !m_isBackgroundCrawl) {
+        if (!settingsPage->m_isContentDeferred) {
+            settingsPage->m_isContentDeferred = true;
 
-    widgetLayout->addWidget(pageWidget);
-    widgetLayout->addSpacerItem(new QSpacerItem(0,0, QSizePolicy::Preferred, QSizePolicy::Expanding));
+            m_deferredContentCount++;
+        }
 
-    widget->setLayout(widgetLayout);
+        return;
+    }
 
-    tabWidget->addTab(widget, page->category());
+    // the widget of a page that could not be loaded is a placeholder, which has no content to index
 
-    m_stackedWidget->addWidget(tabWidget);
+    if (settingsPage->m_widget && !page) {
+        return;
+    }
 
-    auto settingsPage = new SettingsPage;
+    m_pendingContent.append(settingsPage);
+
+    if (!m_contentTimer->isActive()) {
+        m_contentTimer->start();
+    }
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::setPageContent(
+        SettingsPage *settingsPage,
+        const QList<SearchContentItem> &items) -> void {
+
+    QStringList content;
+
+    for (auto &item : items) {
+        m_searchIndex->addText(settingsPage->m_document, item.m_text);
+
+        content.append(item.m_text);
+    }
+
+    settingsPage->m_searchText[FuzzyMatcher::Content] = FuzzyMatcher::normalise(content.join(" "));
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::crawlNextPageContent() -> void {
+    if (m_pendingContent.isEmpty()) {
+        m_contentTimer->stop();
+
+        if (m_contentCache->isModified()) {
+            m_contentCache->save(SearchContentCache::defaultFileName());
+        }
+
+        writeSearchIndex();
+
+        return;
+    }
+
+    auto settingsPage = m_pendingContent.takeFirst();
+    auto widget = settingsPage->m_widget;
+
+    if (!widget) {
+        // background crawling was disabled after the page was queued, so it waits for the page to be shown
+
+        if (!m_isBackgroundCrawl) {
+            settingsPage->m_isContentDeferred = true;
+
+            m_deferredContentCount++;
+
+            return;
+        }
+
+        // the page was not shown before its turn came, a temporary instance of its widget is crawled instead
+
+        auto page = resolvePage(settingsPage);
+
+        if (!page) {
+            return;
+        }
+
+        widget = page->createWidget();
+    } else if (!settingsPage->m_pageSettings) {
+        return;
+    }
+
+    auto page = settingsPage->m_pageSettings;
+    auto items = SearchContentCache::crawl(widget);
+
+    if (widget!=settingsPage->m_widget) {
+        delete widget;
+    }
+
+    m_contentCache->setContent(page->identifier(), page->version(), items);
+
+    setPageContent(settingsPage, items);
+
+    if (!m_searchEdit->text().isEmpty()) {
+        updateSearchResults(m_searchEdit->text());
+    }
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::showPage(SettingsPage *settingsPage) -> void {
+    auto section = settingsPage->m_section;
+
+    buildSection(section);
+
+    // the tab is selected before the section so that only the requested tab is loaded
+
+    if (section->m_tabWidget) {
+        section->m_tabWidget->setCurrentIndex(section->m_pages.indexOf(settingsPage));
+    }
+
+    m_treeWidget->setCurrentItem(section->m_treeItem);
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::resolvePage(SettingsPage *settingsPage) -> ISettingsPage * {
+    if (settingsPage->m_pageSettings || !settingsPage->m_resolver) {
+        return settingsPage->m_pageSettings;
+    }
+
+    auto page = settingsPage->m_resolver(settingsPage->m_descriptor);
+
+    settingsPage->m_resolver = SettingsPageResolver();
+
+    if (!page) {
+        return nullptr;
+    }
 
-    settingsPage->m_name = page->section();
-    settingsPage->m_widget = pageWidget;
     settingsPage->m_pageSettings = page;
-    settingsPage->m_icon = page->icon();
-    settingsPage->m_description = page->description();
 
-    return settingsPage;
-#endif
+    connectPage(page);
+
+    return page;
 }
 
-#pragma clang diagnostic push
-#pragma ide diagnostic ignored "ConstantConditionsOC"
-#pragma ide diagnostic ignored "UnreachableCode"
-auto Nedrysoft::SettingsDialog::SettingsDialog::closeEvent(QCloseEvent *event) -> void {
-    if (okToClose()) {
-        event->accept();
+auto Nedrysoft::SettingsDialog::SettingsDialog::createPageWidget(SettingsPage *settingsPage) -> QWidget * {
+    auto page = resolvePage(settingsPage);
 
-        Q_EMIT closed();
+    if (page) {
+        settingsPage->m_widget = page->createWidget();
+
+        m_settingsSnapshot->capture(page);
+        m_validationCache->addPage(page);
+
+        m_editedValues[page] = page->settingsSnapshot();
     } else {
-        event->ignore();
+        auto placeholder = new QLabel(tr("This page could not be loaded."));
+
+        placeholder->setAlignment(Qt::AlignCenter);
+
+        settingsPage->m_widget = placeholder;
+    }
+
+    // the content of a page without a cached entry is crawled now that the dialog owns its widget, a page that
+    // could not be loaded has no content and no longer holds back the index file.
+
+    if (settingsPage->m_isContentDeferred) {
+        settingsPage->m_isContentDeferred = false;
+
+        m_deferredContentCount--;
+
+        if (page) {
+            indexPageContent(settingsPage);
+        } else if (m_pendingContent.isEmpty() && !m_contentTimer->isActive()) {
+            writeSearchIndex();
+        }
     }
+
+    return settingsPage->m_widget;
 }
-#pragma clang diagnostic pop
 
-auto Nedrysoft::SettingsDialog::SettingsDialog::acceptSettings() -> bool {
-    bool settingsValid = true;
+auto Nedrysoft::SettingsDialog::SettingsDialog::sectionPage(
+        SettingsSection *section) -> Nedrysoft::SettingsDialog::SettingsPage * {
 
-#if defined(Q_OS_MACOS)
-    for(auto page : m_pages) {
-        for (auto section : page->m_pageSettings) {
-            if (!section->canAcceptSettings()) {
-                settingsValid = false;
-                break;
-            }
+    if (section->m_tabWidget) {
+        auto index = section->m_tabWidget->currentIndex();
+
+        if ((index>=0) && (index<section->m_pages.count())) {
+            return section->m_pages.at(index);
         }
     }
 
-    if (!settingsValid) {
-        //TODO go to page with error
-    } else {
-        for(auto page : m_pages) {
-            for (auto section : page->m_pageSettings) {
-                section->acceptSettings();
-            }
+    return section->m_pages.first();
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::prefetchPage(SettingsPage *settingsPage) -> void {
+    auto section = settingsPage->m_section;
+
+    // building a section adds it to the stacked widget without changing the current widget, a tab is loaded
+    // without selecting it so the tab widget does not need to be visible.
+
+    buildSection(section);
+
+    if (section->m_tabWidget) {
+        loadSectionTab(section, section->m_pages.indexOf(settingsPage));
+    }
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::loadShownPage(SettingsPage *settingsPage) -> void {
+    m_prefetchPolicy->shown(settingsPage->m_document, settingsPage->m_widget!=nullptr);
+
+    prefetchPage(settingsPage);
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::filterNavigation(const QString &text) -> void {
+    QSet<SettingsSection *> matchingSections;
+
+    auto showAll = text.isEmpty();
+
+    if (!showAll) {
+        for (auto document : m_searchResults) {
+            matchingSections.insert(m_pages.at(document)->m_section);
         }
+    }
 
-        return true;
+    for (auto section : m_sections) {
+        auto isHidden = !(showAll || matchingSections.contains(section));
+
+        if (section->m_treeItem->isHidden()!=isHidden) {
+            section->m_treeItem->setHidden(isHidden);
+        }
     }
-#else
-    for(auto page : m_pages) {
+}
+#endif
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::open(
+        const QString &section,
+        const QString &category,
+        const QString &optionId) -> bool {
+
+    QWidget *pageWidget = nullptr;
+
+#if defined(Q_OS_MACOS)
+    SettingsPage *settingsPage = nullptr;
+
+    for (auto currentPage : m_pages) {
+        if (currentPage->m_name==section) {
+            settingsPage = currentPage;
 
-        if (!page->m_pageSettings->canAcceptSettings()) {
-            settingsValid = false;
             break;
         }
     }
 
-    if (!settingsValid) {
-        //TODO go to page with error
-    } else {
-        for(auto page : m_pages) {
-            page->m_pageSettings->acceptSettings();
+    if (!settingsPage) {
+        return false;
+    }
+
+    selectSection(settingsPage);
+
+    pageWidget = settingsPage->m_widget;
+#else
+    auto settingsSection = m_sections.value(section);
+
+    if (!settingsSection) {
+        return false;
+    }
+
+    SettingsPage *settingsPage = nullptr;
+
+    for (auto currentPage : settingsSection->m_pages) {
+        if (category.isEmpty() || (currentPage->m_category==category)) {
+            settingsPage = currentPage;
+
+            break;
         }
+    }
+
+    if (!settingsPage) {
+        return false;
+    }
+
+    // only the requested page is created here, the remaining sections and tabs are created as they are shown
 
-        this->m_applyButton->setDisabled(true);
+    showPage(settingsPage);
 
+    pageWidget = settingsPage->m_widget;
+#endif
+
+    show();
+    raise();
+    activateWindow();
+
+    if (optionId.isEmpty() || !pageWidget) {
         return true;
     }
+
+    auto option = (pageWidget->objectName()==optionId) ? pageWidget : pageWidget->findChild<QWidget *>(optionId);
+
+    if (!option) {
+        return false;
+    }
+
+    for (auto parentWidget = option->parentWidget();parentWidget;parentWidget = parentWidget->parentWidget()) {
+        auto scrollArea = qobject_cast<QScrollArea *>(parentWidget);
+
+        if (scrollArea) {
+            scrollArea->ensureWidgetVisible(option);
+        }
+    }
+
+    option->setFocus(Qt::OtherFocusReason);
+
+    return true;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::prefetchStatistics() -> Nedrysoft::SettingsDialog::PrefetchPolicy::Statistics {
+#if defined(Q_OS_MACOS)
+    return PrefetchPolicy::Statistics();
+#else
+    return m_prefetchPolicy->statistics();
+#endif
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::setBackgroundCrawl(bool isBackgroundCrawl) -> void {
+#if defined(Q_OS_MACOS)
+    Q_UNUSED(isBackgroundCrawl)
+#else
+    if (m_isBackgroundCrawl==isBackgroundCrawl) {
+        return;
+    }
+
+    m_isBackgroundCrawl = isBackgroundCrawl;
+
+    if (!m_isBackgroundCrawl) {
+        return;
+    }
+
+    // the pages that were waiting to be shown are queued for crawling
+
+    for (auto settingsPage : m_pages) {
+        if (!settingsPage->m_isContentDeferred) {
+            continue;
+        }
+
+        settingsPage->m_isContentDeferred = false;
+
+        m_deferredContentCount--;
+
+        m_pendingContent.append(settingsPage);
+    }
+
+    if (!m_pendingContent.isEmpty() && !m_contentTimer->isActive()) {
+        m_contentTimer->start();
+    }
 #endif
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::isBackgroundCrawl() -> bool {
+#if defined(Q_OS_MACOS)
     return false;
+#else
+    return m_isBackgroundCrawl;
+#endif
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::updateTitlebar() -> void {
+#if defined(Q_OS_MACOS)
+    Nedrysoft::MacHelper::MacHelper macHelper;
+
+    auto themeSupport = Nedrysoft::ThemeSupport::ThemeSupport::getInstance();
+
+    if (themeSupport->isForced()) {
+        QColor colour;
+
+        if (themeSupport->isDarkMode()) {
+            colour = QColor::fromRgbF(0.23, 0.22, 0.23);
+        } else {
+            colour = QColor::fromRgbF(0.91, 0.90, 0.91);
+        }
+        
+        macHelper.setTitlebarColour(
+                this,
+                colour,
+                themeSupport->isDarkMode()
+        );
+    } else {
+        macHelper.clearTitlebarColour(this, themeSupport->isDarkMode());
+    }
+#endif
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::sizeHint() -> QSize {
+    if (m_currentPage) {
+        return m_currentPage->m_widget->sizeHint();
+    }
+
+    return QWidget::sizeHint();
+}
+
+Nedrysoft::SettingsDialog::SettingsDialog::~SettingsDialog() {
+    setVisiblePages(QList<ISettingsPage *>());
+
+#if defined(Q_OS_MACOS)
+    delete m_toolbar;
+#else
+    // a page that is being applied on a worker thread must finish before the pages are released
+
+    m_applyPipeline->cancel();
+
+    delete m_applyPipeline;
+
+    for (auto page : m_pages) {
+        if (page->m_pageSettings) {
+            disconnect(page->m_pageSettings, 0, 0, 0);
+        }
+
+        delete page;
+    }
+
+    qDeleteAll(m_sections);
+
+    if (m_contentCache->isModified()) {
+        m_contentCache->save(SearchContentCache::defaultFileName());
+    }
+
+    delete m_contentCache;
+    delete m_searchIndex;
+    delete m_mappedIndex;
+
+    delete m_layout;
+    delete m_treeWidget;
+    delete m_categoryLabel;
+    delete m_stackedWidget;
+#endif
+
+    delete m_settingsSnapshot;
+    delete m_journal;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::okToClose() -> bool {
+#if defined(Q_OS_MACOS)
+    if (m_isLiveApply) {
+        applyPendingLiveChanges();
+    }
+#else
+    // the dialog cannot close while pages are being applied, the pipeline must finish or be cancelled first.  In
+    // live mode the apply was not started by the user, so the dialog closes once it finishes.
+
+    if (m_applyPipeline->isRunning()) {
+        if (m_isLiveApply) {
+            m_isClosingAfterApply = true;
+        }
+
+        return false;
+    }
+
+    // live changes that are still waiting for their timer are applied, if that starts a background apply then the
+    // dialog closes once it finishes, otherwise the dialog closes now.
+
+    if (m_isLiveApply) {
+        m_isClosingAfterApply = true;
+
+        if (applyPendingLiveChanges()) {
+            return false;
+        }
+
+        m_isClosingAfterApply = false;
+    }
+
+    QList<ISettingsPage *> pages;
+
+    for(auto page : m_pages) {
+        // pages that have never been shown have no widget and therefore cannot have been modified
+
+        if (page->m_widget && page->m_pageSettings) {
+            pages.append(page->m_pageSettings);
+        }
+    }
+
+    auto invalidPage = firstInvalidPage(pages);
+
+    if (invalidPage) {
+        showPageFor(invalidPage);
+
+        return false;
+    }
+#endif
+    return true;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::resizeEvent(QResizeEvent *event) -> void {
+    for(auto page : m_pages) {
+        if (page->m_widget) {
+#if defined(Q_OS_MACOS)
+            page->m_widget->resize((event->size()));
+#else
+            // pages that are placed directly into the stacked widget are sized by its layout, pages within a
+            // tabbed section need to account for the category label & margins
+
+            if (page->m_widget==page->m_section->m_widget) {
+                continue;
+            }
+
+            auto margins = m_layout->contentsMargins();
+
+            auto adjustment = margins.bottom()+m_categoryLabel->height()+m_layout->spacing();
+
+            page->m_widget->resize(m_stackedWidget->size()-QSize(margins.right(), adjustment));
+#endif
+        }
+    }
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::nativeWindowHandle() -> QWindow * {
+    //
+    // @note the call to winId() is required as it sets up windowHandle() to return the correct value,
+    //       failing to call this will result in windowHandle not returning the correct value.
+
+    window()->winId();
+
+    return window()->windowHandle();
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::addPage(
+        const SettingsPageDescriptor &descriptor,
+        ISettingsPage *page,
+        const SettingsPageResolver &resolver) -> Nedrysoft::SettingsDialog::SettingsPage * {
+
+    auto themeSupport = Nedrysoft::ThemeSupport::ThemeSupport::getInstance();
+
+#if defined(Q_OS_MACOS)
+    Q_UNUSED(descriptor)
+    Q_UNUSED(resolver)
+
+    TransparentWidget *widgetContainer = nullptr;
+    SettingsPage *settingsPage = nullptr;
+
+    for(auto currentPage : m_pages) {
+        if (currentPage->m_name==page->section()) {
+            widgetContainer = currentPage->m_widget;
+            settingsPage = currentPage;
+
+            break;
+        }
+    }
+
+    if (!widgetContainer) {
+        widgetContainer = new TransparentWidget(0, this);
+    }
+
+    if (widgetContainer->count()) {
+        widgetContainer->addWidget(new SeparatorWidget);
+    }
+
+    auto pageWidget = page->createWidget();
+
+    m_settingsSnapshot->capture(page);
+    m_validationCache->addPage(page);
+
+    m_editedValues[page] = page->settingsSnapshot();
+
+    connectPage(page);
+
+    widgetContainer->addWidget(pageWidget);
+
+    if (settingsPage) {
+#if defined(Q_OS_MACOS)
+        settingsPage->m_pageSettings.append(page);
+#endif
+        return settingsPage;
+    }
+
+    settingsPage = new SettingsPage;
+
+    settingsPage->m_name = page->section();
+    settingsPage->m_widget = widgetContainer;
+#if defined(Q_OS_MACOS)
+    settingsPage->m_pageSettings.append(page);
+#else
+    settingsPage->m_pageSettings = page;
+#endif
+    settingsPage->m_icon = page->icon(themeSupport->isDarkMode());
+    settingsPage->m_description = page->description();
+
+    if (pageWidget->layout()) {
+        pageWidget->layout()->setSizeConstraint(QLayout::SetMinimumSize);
+    }
+
+    settingsPage->m_toolbarItem = m_toolbar->addItem(
+            page->icon(themeSupport->isDarkMode()),
+            page->section());
+
+    m_pages[settingsPage->m_toolbarItem] = settingsPage;
+
+    connect(settingsPage->m_toolbarItem,
+            &Nedrysoft::MacHelper::MacToolbarItem::activated,
+            this,
+            [this, settingsPage]() {
+
+        selectSection(settingsPage);
+    });
+
+    return settingsPage;
+#else
+    auto sectionName = descriptor.m_section;
+    auto section = m_sections.value(sectionName);
+
+    if (!section) {
+        auto treeItem = new QTreeWidgetItem;
+
+        treeItem->setIcon(0, descriptor.icon(themeSupport->isDarkMode()));
+        treeItem->setText(0, sectionName);
+        treeItem->setData(0, Qt::ToolTipRole, descriptor.m_description);
+
+        auto signal = connect(
+            themeSupport,
+            &Nedrysoft::ThemeSupport::ThemeSupport::themeChanged,
+            [=](bool isDarkMode) {
+
+                treeItem->setIcon(0, descriptor.icon(isDarkMode));
+            }
+        );
+
+        connect(this, &QObject::destroyed, [themeSupport, signal]() {
+            themeSupport->disconnect(signal);
+        });
+
+        section = new SettingsSection;
+
+        section->m_name = sectionName;
+        section->m_treeItem = treeItem;
+        section->m_weight = descriptor.m_weight;
+
+        // a section added by a later batch is inserted after the sections with the same or a lower weight
+
+        m_sections[sectionName] = section;
+        m_sectionItems[treeItem] = section;
+
+        m_treeWidget->insertTopLevelItem(sectionItemPosition(section), treeItem);
+    } else if (descriptor.m_weight<section->m_weight) {
+        // a later batch has added a page with a lower weight to an existing section, the section is moved so that
+        // the sections remain ordered by the lowest weight of the pages that they contain.
+
+        section->m_weight = descriptor.m_weight;
+
+        QSignalBlocker signalBlocker(m_treeWidget);
+
+        auto treeItem = section->m_treeItem;
+        auto isCurrent = (m_treeWidget->currentItem()==treeItem);
+        auto isHidden = treeItem->isHidden();
+
+        m_treeWidget->takeTopLevelItem(m_treeWidget->indexOfTopLevelItem(treeItem));
+        m_treeWidget->insertTopLevelItem(sectionItemPosition(section), treeItem);
+
+        treeItem->setHidden(isHidden);
+
+        if (isCurrent) {
+            m_treeWidget->setCurrentItem(treeItem);
+        }
+    }
+
+    if (page) {
+        connectPage(page);
+    }
+
+    auto settingsPage = new SettingsPage;
+
+    settingsPage->m_name = sectionName;
+    settingsPage->m_category = descriptor.m_category;
+    settingsPage->m_pageSettings = page;
+    settingsPage->m_descriptor = descriptor;
+    settingsPage->m_resolver = resolver;
+    settingsPage->m_icon = descriptor.icon();
+    settingsPage->m_description = descriptor.m_description;
+    settingsPage->m_section = section;
+
+    auto document = m_pages.count();
+
+    settingsPage->m_document = document;
+
+    m_searchIndex->addText(document, sectionName);
+    m_searchIndex->addText(document, settingsPage->m_category);
+    m_searchIndex->addText(document, settingsPage->m_description);
+    m_searchIndex->addText(document, descriptor.m_keywords.join(" "));
+
+    settingsPage->m_searchText = QStringList()
+            << FuzzyMatcher::normalise(sectionName)
+            << FuzzyMatcher::normalise(settingsPage->m_category)
+            << FuzzyMatcher::normalise(settingsPage->m_description+" "+descriptor.m_keywords.join(" "))
+            << QString();
+
+    m_pages.append(settingsPage);
+
+    auto position = sectionPosition(section, settingsPage);
+
+    if (section->m_widget) {
+        // the section has already been built, so the page is added to the existing container, a single category
+        // section is converted to a tabbed section in place.
+
+        if (!section->m_tabWidget) {
+            auto stackIndex = m_stackedWidget->indexOf(section->m_widget);
+            auto isCurrent = (m_stackedWidget->currentWidget()==section->m_widget);
+
+            m_stackedWidget->removeWidget(section->m_widget);
+
+            createSectionTabWidget(section);
+
+            addSectionTab(section, section->m_pages.first());
+
+            section->m_widget = section->m_tabWidget;
+
+            m_stackedWidget->insertWidget(stackIndex, section->m_widget);
+
+            if (isCurrent) {
+                m_stackedWidget->setCurrentWidget(section->m_widget);
+            }
+        }
+
+        section->m_pages.insert(position, settingsPage);
+
+        addSectionTab(section, settingsPage, position);
+    } else {
+        section->m_pages.insert(position, settingsPage);
+    }
+
+    sortSectionPages(section);
+
+    return settingsPage;
+#endif
+}
+
+#if !defined(Q_OS_MACOS)
+auto Nedrysoft::SettingsDialog::SettingsDialog::buildSection(SettingsSection *section) -> void {
+    if (section->m_widget) {
+        return;
+    }
+
+    if (section->m_pages.count()==1) {
+        // a section with a single category has no need for a tab bar, the page widget is placed directly into the
+        // stacked widget.
+
+        auto settingsPage = section->m_pages.first();
+
+        settingsPage->m_widget = createPageWidget(settingsPage);
+
+        section->m_widget = settingsPage->m_widget;
+    } else {
+        // the tabs are created using the known category names, the content of each tab is created the first
+        // time that the tab is shown.
+
+        createSectionTabWidget(section);
+
+        for (auto settingsPage : section->m_pages) {
+            addSectionTab(section, settingsPage);
+        }
+
+        section->m_widget = section->m_tabWidget;
+    }
+
+    m_stackedWidget->addWidget(section->m_widget);
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::sectionPosition(
+        SettingsSection *section,
+        SettingsPage *settingsPage) -> int {
+
+    auto weight = settingsPage->m_descriptor.m_weight;
+    auto lastOfCategory = -1;
+    QHash<QString, int> categoryWeights;
+
+    for (auto index=0;index<section->m_pages.count();index++) {
+        auto currentPage = section->m_pages.at(index);
+        auto currentWeight = currentPage->m_descriptor.m_weight;
+
+        if (currentPage->m_category==settingsPage->m_category) {
+            // pages of an existing category are kept together, ordered by weight
+
+            if (currentWeight>weight) {
+                return index;
+            }
+
+            lastOfCategory = index;
+        }
+
+        if (!categoryWeights.contains(currentPage->m_category)) {
+            categoryWeights[currentPage->m_category] = currentWeight;
+        } else {
+            categoryWeights[currentPage->m_category] = qMin(categoryWeights[currentPage->m_category], currentWeight);
+        }
+    }
+
+    if (lastOfCategory!=-1) {
+        return lastOfCategory+1;
+    }
+
+    // a new category is placed before the first category with a higher weight
+
+    for (auto index=0;index<section->m_pages.count();index++) {
+        if (categoryWeights.value(section->m_pages.at(index)->m_category)>weight) {
+            return index;
+        }
+    }
+
+    return section->m_pages.count();
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::sortSectionPages(SettingsSection *section) -> void {
+    QHash<QString, int> categoryWeights;
+
+    for (auto settingsPage : section->m_pages) {
+        auto weight = settingsPage->m_descriptor.m_weight;
+
+        if (!categoryWeights.contains(settingsPage->m_category)) {
+            categoryWeights[settingsPage->m_category] = weight;
+        } else {
+            categoryWeights[settingsPage->m_category] = qMin(categoryWeights[settingsPage->m_category], weight);
+        }
+    }
+
+    // the pages of a category are kept together by sectionPosition(), so a stable sort by category weight only
+    // moves a category whose weight was lowered by a page added after it.
+
+    auto orderedPages = section->m_pages;
+
+    std::stable_sort(orderedPages.begin(), orderedPages.end(), [&](SettingsPage *left, SettingsPage *right) {
+        return categoryWeights.value(left->m_category)<categoryWeights.value(right->m_category);
+    });
+
+    for (auto index=0;index<orderedPages.count();index++) {
+        auto currentIndex = section->m_pages.indexOf(orderedPages.at(index), index);
+
+        if (currentIndex==index) {
+            continue;
+        }
+
+        section->m_pages.move(currentIndex, index);
+
+        if (section->m_tabWidget) {
+            section->m_tabWidget->tabBar()->moveTab(currentIndex, index);
+        }
+    }
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::sectionItemPosition(SettingsSection *section) -> int {
+    for (auto index=0;index<m_treeWidget->topLevelItemCount();index++) {
+        auto treeItem = m_treeWidget->topLevelItem(index);
+
+        if ((treeItem!=section->m_treeItem) && (m_sectionItems.value(treeItem)->m_weight>section->m_weight)) {
+            return index;
+        }
+    }
+
+    return m_treeWidget->topLevelItemCount();
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::addSectionTab(
+        SettingsSection *section,
+        SettingsPage *settingsPage,
+        int index) -> void {
+
+    auto widget = new QWidget;
+    auto widgetLayout = new QVBoxLayout;
+
+    if (settingsPage->m_widget) {
+        widgetLayout->addWidget(settingsPage->m_widget);
+    }
+
+    widgetLayout->addSpacerItem(new QSpacerItem(0,0, QSizePolicy::Preferred, QSizePolicy::Expanding));
+
+    widget->setLayout(widgetLayout);
+
+    section->m_tabWidget->insertTab(index, widget, settingsPage->m_category);
+
+    updateTabValidity(settingsPage);
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::createSectionTabWidget(SettingsSection *section) -> void {
+    section->m_tabWidget = new QTabWidget;
+
+    connect(section->m_tabWidget, &QTabWidget::currentChanged, [=](int index) {
+        // tabs are only loaded once the section is visible, this ignores the change that occurs when the first
+        // tab is added while the section is being built.
+
+        if (section->m_widget && (m_stackedWidget->currentWidget()==section->m_widget)) {
+            if ((index>=0) && (index<section->m_pages.count())) {
+                loadShownPage(section->m_pages.at(index));
+            }
+
+            updateVisiblePages();
+        }
+    });
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::loadSectionTab(SettingsSection *section, int index) -> void {
+    if ((index<0) || (index>=section->m_pages.count())) {
+        return;
+    }
+
+    auto settingsPage = section->m_pages.at(index);
+
+    if (settingsPage->m_widget) {
+        return;
+    }
+
+    auto widgetLayout = qobject_cast<QVBoxLayout *>(section->m_tabWidget->widget(index)->layout());
+
+    settingsPage->m_widget = createPageWidget(settingsPage);
+
+    widgetLayout->insertWidget(0, settingsPage->m_widget);
+}
+#endif
+
+#if defined(Q_OS_MACOS)
+auto Nedrysoft::SettingsDialog::SettingsDialog::selectSection(SettingsPage *settingsPage) -> void {
+    if (!m_currentPage) {
+        m_currentPage = settingsPage;
+        m_currentPage->m_widget->setOpacity(1);
+
+        updateVisiblePages();
+
+        resize(m_currentPage->m_widget->sizeHint());
+
+        this->setWindowTitle(settingsPage->m_name);
+
+        return;
+    }
+
+    auto currentItem = m_pages[m_currentPage->m_toolbarItem]->m_widget;
+    auto nextItem = settingsPage->m_widget;
+
+    if (currentItem==nextItem) {
+        return;
+    }
+
+    if (m_animationGroup) {
+        m_animationGroup->stop();
+        m_animationGroup->deleteLater();
+    }
+
+    m_animationGroup = new QParallelAnimationGroup;
+
+    auto minSize = QSize(m_maximumWidth, nextItem->sizeHint().height());
+
+    auto propertyNames = {"size", "minimumSize", "maximumSize"};
+
+    for(auto property : propertyNames) {
+        auto sizeAnimation = new QPropertyAnimation(this, property);
+
+        sizeAnimation->setDuration(TransisionDuration.count());
+        sizeAnimation->setStartValue(currentItem->size());
+        sizeAnimation->setEndValue(minSize);
+
+        m_animationGroup->addAnimation(sizeAnimation);
+    }
+
+    auto outgoingAnimation = new QPropertyAnimation(currentItem->transparencyEffect(), "opacity");
+
+    outgoingAnimation->setDuration(TransisionDuration.count());
+    outgoingAnimation->setStartValue(currentItem->transparencyEffect()->opacity());
+    outgoingAnimation->setEndValue(AlphaTransparent);
+
+    m_animationGroup->addAnimation(outgoingAnimation);
+
+    auto incomingAnimation = new QPropertyAnimation(nextItem->transparencyEffect(), "opacity");
+
+    incomingAnimation->setDuration(TransisionDuration.count());
+    incomingAnimation->setStartValue(nextItem->transparencyEffect()->opacity());
+    incomingAnimation->setEndValue(AlphaOpaque);
+
+    m_animationGroup->addAnimation(incomingAnimation);
+
+    m_animationGroup->start(QParallelAnimationGroup::DeleteWhenStopped);
+
+    // the current page is set here immediately, so that if the page is changed again before the animation is
+    // complete then the new selection will be animated in from the current position in the previous animation
+
+    m_currentPage = settingsPage;
+
+    updateVisiblePages();
+
+    connect(m_animationGroup, &QParallelAnimationGroup::finished, [this, settingsPage]() {
+        m_animationGroup->deleteLater();
+
+        m_animationGroup = nullptr;
+
+        this->setWindowTitle(settingsPage->m_name);
+    });
+}
+#endif
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "ConstantConditionsOC"
+#pragma ide diagnostic ignored "UnreachableCode"
+auto Nedrysoft::SettingsDialog::SettingsDialog::closeEvent(QCloseEvent *event) -> void {
+    if (okToClose()) {
+        event->accept();
+
+#if !defined(Q_OS_MACOS)
+        // pages prepared by an apply that did not complete are rolled back when the dialog is dismissed
+
+        m_applyPipeline->discard();
+#endif
+
+        Q_EMIT closed();
+    } else {
+        event->ignore();
+    }
+}
+#pragma clang diagnostic pop
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::showEvent(QShowEvent *event) -> void {
+    QWidget::showEvent(event);
+
+#if !defined(Q_OS_MACOS)
+    // the first section is selected when the dialog is shown unless a page has already been opened
+
+    if (!m_treeWidget->currentItem() && m_treeWidget->topLevelItemCount()) {
+        m_treeWidget->setCurrentItem(m_treeWidget->topLevelItem(0));
+    }
+#endif
+
+    if (!isMinimized()) {
+        setVisiblePages(currentPages());
+    }
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::hideEvent(QHideEvent *event) -> void {
+    QWidget::hideEvent(event);
+
+    setVisiblePages(QList<ISettingsPage *>());
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::changeEvent(QEvent *event) -> void {
+    QWidget::changeEvent(event);
+
+    if (event->type()==QEvent::WindowStateChange) {
+        if (isMinimized()) {
+            setVisiblePages(QList<ISettingsPage *>());
+        } else {
+            updateVisiblePages();
+        }
+    }
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::eventFilter(QObject *watched, QEvent *event) -> bool {
+#if !defined(Q_OS_MACOS)
+    // a pending prefetch is abandoned when the pointer leaves the navigation tree
+
+    if ((watched==m_treeWidget->viewport()) && (event->type()==QEvent::Leave)) {
+        m_prefetchPolicy->cancel();
+    }
+#endif
+
+    return QWidget::eventFilter(watched, event);
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::currentPages() -> QList<ISettingsPage *> {
+#if defined(Q_OS_MACOS)
+    if (m_currentPage) {
+        return m_currentPage->m_pageSettings;
+    }
+#else
+    auto section = m_sectionItems.value(m_treeWidget->currentItem());
+
+    if (section && section->m_widget) {
+        if (section->m_tabWidget) {
+            auto index = section->m_tabWidget->currentIndex();
+
+            if ((index>=0) && (index<section->m_pages.count()) && section->m_pages.at(index)->m_pageSettings) {
+                return QList<ISettingsPage *>() << section->m_pages.at(index)->m_pageSettings;
+            }
+        } else if (section->m_pages.first()->m_pageSettings) {
+            return QList<ISettingsPage *>() << section->m_pages.first()->m_pageSettings;
+        }
+    }
+#endif
+    return QList<ISettingsPage *>();
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::updateVisiblePages() -> void {
+    if (isVisible() && !isMinimized()) {
+        setVisiblePages(currentPages());
+    }
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::setVisiblePages(const QList<ISettingsPage *> &pages) -> void {
+    for (auto page : m_visiblePages) {
+        if (!pages.contains(page)) {
+            page->pageHidden();
+        }
+    }
+
+    for (auto page : pages) {
+        if (!m_visiblePages.contains(page)) {
+            page->pageShown();
+        }
+    }
+
+    m_visiblePages = pages;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::acceptSettings() -> AcceptStatus {
+    QList<ISettingsPage *> pages;
+
+#if defined(Q_OS_MACOS)
+    for(auto page : m_pages) {
+        pages += page->m_pageSettings;
+    }
+#else
+    for(auto page : m_pages) {
+        if (page->m_widget && page->m_pageSettings) {
+            pages.append(page->m_pageSettings);
+        }
+    }
+#endif
+
+    auto invalidPage = firstInvalidPage(pages);
+
+    if (invalidPage) {
+        showPageFor(invalidPage);
+    } else {
+#if defined(Q_OS_MACOS)
+        for (auto page : changedPages(pages)) {
+            page->acceptSettings();
+        }
+
+        commitChanges();
+
+        auto isApplied = SettingsStore::getInstance()->flush();
+
+        Q_EMIT settingsApplied(isApplied);
+
+        return isApplied ? AcceptStatus::Applied : AcceptStatus::Failed;
+#else
+        m_hasPendingChanges = false;
+
+        m_okButton->setDisabled(true);
+        m_applyButton->setDisabled(true);
+
+        m_progressBar->setValue(0);
+        m_progressBar->setVisible(true);
+
+        m_applyPipeline->start(changedPages(pages));
+
+        return AcceptStatus::Started;
+#endif
+    }
+
+    return AcceptStatus::Invalid;
+}
+
+#if !defined(Q_OS_MACOS)
+auto Nedrysoft::SettingsDialog::SettingsDialog::applyFinished(bool isApplied) -> void {
+    // the values written by the pages are persisted with a single write, this includes the pages that were applied
+    // before a failure or cancellation.  The changes found by the snapshot are only written if every page applied.
+
+    if (isApplied) {
+        commitChanges();
+    } else {
+        m_pendingChanges.clear();
+
+        SettingsSchema::getInstance()->reload();
+    }
+
+    if (!SettingsStore::getInstance()->flush()) {
+        isApplied = false;
+    }
+
+    m_progressBar->setVisible(false);
+
+    m_okButton->setDisabled(false);
+    m_cancelButton->setDisabled(false);
+
+    // changes made while the pipeline was running have not been applied
+
+    m_applyButton->setDisabled(isApplied && !m_hasPendingChanges);
+
+    Q_EMIT settingsApplied(isApplied);
+
+    if (!isApplied) {
+        m_isClosingAfterApply = false;
+
+        showPageFor(m_applyPipeline->failedPage());
+
+        return;
+    }
+
+    // pages that changed while a live apply was running are applied in the next run, the dialog is closed once
+    // nothing remains to be applied
+
+    if (m_isLiveApply && !m_liveApplyQueue.isEmpty() && startLiveApply()) {
+        return;
+    }
+
+    if (m_isClosingAfterApply) {
+        m_isClosingAfterApply = false;
+
+        close();
+    }
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::markPageValidity(ISettingsPage *page, bool isValid) -> void {
+    if (isValid) {
+        m_invalidPages.remove(page);
+    } else {
+        m_invalidPages.insert(page);
+    }
+
+    SettingsPage *settingsPage = nullptr;
+
+    for (auto currentPage : m_pages) {
+        if (currentPage->m_pageSettings==page) {
+            settingsPage = currentPage;
+
+            break;
+        }
+    }
+
+    if (!settingsPage) {
+        return;
+    }
+
+    // the section is marked while any of its pages is invalid, as the invalid tab may not be the one shown
+
+    auto section = settingsPage->m_section;
+    auto isSectionValid = true;
+
+    for (auto sectionPage : section->m_pages) {
+        if (m_invalidPages.contains(sectionPage->m_pageSettings)) {
+            isSectionValid = false;
+
+            break;
+        }
+    }
+
+    if (isSectionValid) {
+        section->m_treeItem->setData(0, Qt::ForegroundRole, QVariant());
+    } else {
+        section->m_treeItem->setForeground(0, QBrush(Qt::red));
+    }
+
+    if (section->m_tabWidget) {
+        updateTabValidity(settingsPage);
+    }
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::updateTabValidity(SettingsPage *settingsPage) -> void {
+    auto section = settingsPage->m_section;
+    auto index = section->m_pages.indexOf(settingsPage);
+
+    if ((index<0) || (index>=section->m_tabWidget->count())) {
+        return;
+    }
+
+    if (m_invalidPages.contains(settingsPage->m_pageSettings)) {
+        section->m_tabWidget->setTabIcon(index, style()->standardIcon(QStyle::SP_MessageBoxWarning));
+    } else {
+        section->m_tabWidget->setTabIcon(index, QIcon());
+    }
+}
+#endif
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::firstInvalidPage(
+        const QList<ISettingsPage *> &pages) -> Nedrysoft::SettingsDialog::ISettingsPage * {
+
+    // pages that were validated after their last change are not validated again
+
+    auto invalidPage = m_validationCache->firstInvalidPage(pages);
+
+    if (invalidPage) {
+        return invalidPage;
+    }
+
+    // a constraint can be broken by a change on another page, so the constraints of every page are checked,
+    // including pages that have not been shown and therefore cannot be validated by canAcceptSettings().
+
+    return m_constraintRegistry->firstInvalidPage();
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::showPageFor(ISettingsPage *page) -> void {
+    if (!page) {
+        return;
+    }
+
+    for (auto settingsPage : m_pages) {
+#if defined(Q_OS_MACOS)
+        if (settingsPage->m_pageSettings.contains(page)) {
+            if (settingsPage!=m_currentPage) {
+                selectSection(settingsPage);
+            }
+
+            break;
+        }
+#else
+        if (settingsPage->m_pageSettings==page) {
+            showPage(settingsPage);
+
+            break;
+        }
+#endif
+    }
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::setLiveApply(bool isLiveApply) -> void {
+    m_isLiveApply = isLiveApply;
+
+#if !defined(Q_OS_MACOS)
+    m_applyButton->setVisible(!isLiveApply);
+    m_cancelButton->setVisible(!isLiveApply);
+
+    m_okButton->setText(isLiveApply ? tr("Close") : tr("OK"));
+#endif
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::isLiveApply() -> bool {
+    return m_isLiveApply;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::undo() -> void {
+    if (!m_journal->canUndo()) {
+        return;
+    }
+
+    auto entry = m_journal->undo();
+
+    replaySettingValue(entry.m_page, entry.m_key, entry.m_oldValue);
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::redo() -> void {
+    if (!m_journal->canRedo()) {
+        return;
+    }
+
+    auto entry = m_journal->redo();
+
+    replaySettingValue(entry.m_page, entry.m_key, entry.m_newValue);
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::replaySettingValue(
+        ISettingsPage *page,
+        const QString &key,
+        const QVariant &value) -> void {
+
+    showPageFor(page);
+
+    m_isReplayingJournal = true;
+
+    auto isSet = page->setSettingValue(key, value);
+
+    m_isReplayingJournal = false;
+
+    // a page that cannot set the value leaves the journal out of step with the pages, so the history is dropped
+
+    if (!isSet) {
+        m_journal->clear();
+
+        return;
+    }
+
+    m_constraintRegistry->setValue(key, value);
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::connectPage(ISettingsPage *page) -> void {
+    connect(page, &Nedrysoft::SettingsDialog::ISettingsPage::settingsChanged, [=]() {
+        pageSettingsChanged(page);
+    });
+
+    connect(page,
+            &Nedrysoft::SettingsDialog::ISettingsPage::settingValueChanged,
+            [=](const QString &key, const QVariant &value) {
+
+        // the page has already changed when this is emitted, so the value before the edit is taken from the
+        // values that the page reported previously rather than from the page itself.
+
+        auto &editedValues = m_editedValues[page];
+
+        if (!m_isReplayingJournal) {
+            m_journal->record(page, key, editedValues.value(key), value);
+        }
+
+        editedValues[key] = value;
+
+        m_constraintRegistry->setValue(key, value);
+    });
+
+    page->registerConstraints(m_constraintRegistry);
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::pageSettingsChanged(ISettingsPage *page) -> void {
+    m_validationCache->invalidate(page);
+
+#if !defined(Q_OS_MACOS)
+    // anything kept for the page from a failed apply no longer matches its settings
+
+    m_applyPipeline->invalidate(page);
+#endif
+
+    if (m_isLiveApply) {
+        // each page has its own timer so that a burst of changes to one page (such as dragging a slider) is
+        // applied once, without delaying changes made to other pages.
+
+        auto timer = m_liveApplyTimers.value(page);
+
+        if (!timer) {
+            timer = new QTimer(this);
+
+            timer->setSingleShot(true);
+            timer->setInterval(LiveApplyDelay);
+
+            connect(timer, &QTimer::timeout, [=]() {
+                if (!m_liveApplyQueue.contains(page)) {
+                    m_liveApplyQueue.append(page);
+                }
+
+                startLiveApply();
+            });
+
+            m_liveApplyTimers[page] = timer;
+        }
+
+        timer->start();
+
+        return;
+    }
+
+#if !defined(Q_OS_MACOS)
+    if (m_applyPipeline->isRunning()) {
+        m_hasPendingChanges = true;
+
+        return;
+    }
+
+    m_applyButton->setDisabled(false);
+#endif
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::startLiveApply() -> bool {
+#if defined(Q_OS_MACOS)
+    QList<ISettingsPage *> pages;
+
+    for (auto page : m_liveApplyQueue) {
+        if (m_validationCache->isValid(page)) {
+            pages.append(page);
+        }
+    }
+
+    m_liveApplyQueue.clear();
+
+    for (auto page : changedPages(pages)) {
+        page->acceptSettings();
+    }
+
+    commitChanges();
+
+    Q_EMIT settingsApplied(SettingsStore::getInstance()->flush());
+
+    return false;
+#else
+    // a page that is applied while a run is in progress waits for the run to finish
+
+    if (m_applyPipeline->isRunning()) {
+        return true;
+    }
+
+    QList<ISettingsPage *> pages;
+
+    for (auto page : m_liveApplyQueue) {
+        if (m_validationCache->isValid(page)) {
+            pages.append(page);
+        } else {
+            m_isClosingAfterApply = false;
+
+            showPageFor(page);
+        }
+    }
+
+    m_liveApplyQueue.clear();
+
+    pages = changedPages(pages);
+
+    if (pages.isEmpty()) {
+        return false;
+    }
+
+    m_applyPipeline->start(pages);
+
+    return true;
+#endif
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::changedPages(
+        const QList<ISettingsPage *> &pages) -> QList<Nedrysoft::SettingsDialog::ISettingsPage *> {
+
+    QList<ISettingsPage *> changedPages;
+
+    for (auto page : pages) {
+        // pages that do not report their values are always applied
+
+        if (!m_settingsSnapshot->contains(page)) {
+            changedPages.append(page);
+
+            continue;
+        }
+
+        auto changes = m_settingsSnapshot->changes(page);
+
+        if (changes.isEmpty()) {
+            continue;
+        }
+
+        page->setChangedSettings(changes);
+
+        m_pendingChanges[page] = changes;
+
+        changedPages.append(page);
+    }
+
+    return changedPages;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::commitChanges() -> void {
+    auto settingsStore = SettingsStore::getInstance();
+
+    for (auto page=m_pendingChanges.constBegin();page!=m_pendingChanges.constEnd();page++) {
+        for (auto change=page->constBegin();change!=page->constEnd();change++) {
+            if (change.value().isValid()) {
+                settingsStore->setValue(change.key(), change.value());
+            } else {
+                settingsStore->remove(change.key());
+            }
+        }
+
+        m_settingsSnapshot->update(page.key(), page.value());
+    }
+
+    m_pendingChanges.clear();
+
+    // the typed values are refreshed to include the values written by the pages as well as the changes, reloading
+    // also publishes them to other threads.
+
+    SettingsSchema::getInstance()->reload();
+}
+
+auto Nedrysoft::SettingsDialog::SettingsDialog::applyPendingLiveChanges() -> bool {
+    for (auto timer=m_liveApplyTimers.constBegin();timer!=m_liveApplyTimers.constEnd();timer++) {
+        if (timer.value()->isActive()) {
+            timer.value()->stop();
+
+            if (!m_liveApplyQueue.contains(timer.key())) {
+                m_liveApplyQueue.append(timer.key());
+            }
+        }
+    }
+
+    if (m_liveApplyQueue.isEmpty()) {
+        return false;
+    }
+
+    return startLiveApply();
 }
 
 auto Nedrysoft::SettingsDialog::SettingsDialog::updateStyleSheet(
@@ -26,20 +26,32 @@
 
 #include <QtGlobal>
 
+#include "PrefetchPolicy.h"
 #include "SettingsDialogSpec.h"
+#include "SettingsPageDescriptor.h"
 
+#include <QHash>
 #include <QIcon>
 #include <QList>
 #include <QMap>
+#include <QSet>
 #include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
 #include <QWidget>
 
 class QHBoxLayout;
 class QLabel;
+class QLineEdit;
 class QParallelAnimationGroup;
+class QProgressBar;
 class QPushButton;
 class QStackedWidget;
+class QTimer;
+class QTabWidget;
 class QTreeWidget;
+class QTreeWidgetItem;
 class QVBoxLayout;
 
 namespace Nedrysoft { namespace ThemeSupport {
@@ -52,8 +64,18 @@ namespace Nedrysoft { namespace MacHelper {
 }}
 
 namespace Nedrysoft { namespace SettingsDialog {
+    class ApplyPipeline;
+    class ConstraintRegistry;
     class TransparentWidget;
     class ISettingsPage;
+    class MappedSearchIndex;
+    class SearchContentCache;
+    class SearchContentItem;
+    class SearchIndex;
+    class SettingsJournal;
+    class SettingsSection;
+    class SettingsSnapshot;
+    class ValidationCache;
 
     /**
      * @brief       The SettingsPage class describes an individual page of the application settings
@@ -62,12 +84,16 @@ namespace Nedrysoft { namespace SettingsDialog {
         public:
             SettingsPage() :
 #if defined(Q_OS_MACOS)
-                //m_toolBarItem(nullptr),
-                m_pageSettings(QList<ISettingsPage *>()),
+                m_widget(nullptr),
+                m_toolbarItem(nullptr),
+                m_pageSettings(QList<ISettingsPage *>()) {
 #else
+                m_widget(nullptr),
                 m_pageSettings(nullptr),
+                m_section(nullptr),
+                m_document(-1),
+                m_isContentDeferred(false) {
 #endif
-                m_widget(nullptr) {
 
                 }
 
@@ -75,6 +101,7 @@ namespace Nedrysoft { namespace SettingsDialog {
             //! @cond
 
             QString m_name;
+            QString m_category;
             QString m_description;
 #if defined(Q_OS_MACOS)
             TransparentWidget *m_widget;
@@ -83,12 +110,51 @@ namespace Nedrysoft { namespace SettingsDialog {
 #else
             QWidget *m_widget;
             ISettingsPage *m_pageSettings;
+            SettingsPageDescriptor m_descriptor;
+            SettingsPageResolver m_resolver;
+            SettingsSection *m_section;
+            int m_document;
+            QStringList m_searchText;
+            bool m_isContentDeferred;
 #endif
             QIcon m_icon;
 
             //! @endcond
     };
 
+#if !defined(Q_OS_MACOS)
+    /**
+     * @brief       The SettingsSection class describes a top level section of the settings tree.
+     *
+     * @details     A section with a single category places the page widget directly into the stacked widget,
+     *              sections with multiple categories use a tab widget with a tab per category.  The container of
+     *              a section is created when the section is first shown and the content of each tab is created
+     *              when the tab is first shown.
+     */
+    class SettingsSection {
+        public:
+            SettingsSection() :
+                m_treeItem(nullptr),
+                m_widget(nullptr),
+                m_tabWidget(nullptr),
+                m_weight(0) {
+
+                }
+
+        public:
+            //! @cond
+
+            QString m_name;
+            QTreeWidgetItem *m_treeItem;
+            QWidget *m_widget;
+            QTabWidget *m_tabWidget;
+            QList<SettingsPage *> m_pages;
+            int m_weight;
+
+            //! @endcond
+    };
+#endif
+
     /**
     * @brief        The SettingsDialog class provides a common themed settings dialog for Windows and Linux
     *               and a correctly styled dialog for macOS.
@@ -118,11 +184,131 @@ namespace Nedrysoft { namespace SettingsDialog {
              */
             ~SettingsDialog();
 
+            /**
+             * @brief       Adds a list of settings pages to the settings dialog.
+             *
+             * @details     The pages are grouped by section and category and sorted by weight in a single pass,
+             *              the navigation items and containers are then created as one batch with updates
+             *              suspended.
+             *
+             * @param[in]   pages the pages to be added.
+             */
+            auto addPages(const QList<ISettingsPage *> &pages) -> void;
+
+            /**
+             * @brief       Adds a list of pages described by descriptors to the settings dialog.
+             *
+             * @details     The navigation and search are built from the descriptors alone, the resolver is called
+             *              to create each page the first time that it is shown.
+             *
+             * @note        On macOS all pages are created up front, so the resolver is called for every page.
+             *
+             * @param[in]   descriptors the descriptors of the pages to be added.
+             * @param[in]   resolver the function that creates a page from its descriptor.
+             */
+            auto addPages(const QList<SettingsPageDescriptor> &descriptors, const SettingsPageResolver &resolver) -> void;
+
+            /**
+             * @brief       Opens the dialog at a specific section, category and option.
+             *
+             * @details     Only the requested page is created, all other pages are created as they are shown.  The
+             *              option is located by object name, any scroll areas containing it are scrolled so that it
+             *              is visible and it is given the keyboard focus.
+             *
+             * @param[in]   section the name of the section.
+             * @param[in]   category the name of the category, if empty then the first category is opened.
+             * @param[in]   optionId the object name of the option widget, if empty then no option is focused.
+             *
+             * @returns     true if the page (and option if given) were found; otherwise false.
+             */
+            auto open(const QString &section, const QString &category=QString(), const QString &optionId=QString()) -> bool;
+
+            /**
+             * @brief       Returns the statistics of the page prefetch policy.
+             *
+             * @details     Pages are prefetched when the pointer hovers over a section or when a page becomes the
+             *              best search result, the statistics show how often a prefetch was in time for the page
+             *              being shown.
+             *
+             * @note        All pages are created up front on macOS, so the statistics are always empty.
+             *
+             * @returns     the statistics.
+             */
+            auto prefetchStatistics() -> PrefetchPolicy::Statistics;
+
+            /**
+             * @brief       Sets whether pages that have not been shown are crawled for search content.
+             *
+             * @details     The content of a page is normally taken from the content cache or from
+             *              ISettingsPage::searchText(), otherwise the page can only be found by its option text once
+             *              it has been shown.  With background crawling enabled such pages are loaded when the
+             *              event loop is idle and a temporary instance of their widget is crawled, the content is
+             *              cached so that this only happens once for each version of a page.
+             *
+             * @note        Creating the temporary widget runs the page constructor, so this should only be enabled
+             *              if the widgets of the pages have no side effects.  This has no effect on macOS, where all
+             *              pages are created up front.
+             *
+             * @param[in]   isBackgroundCrawl true to crawl pages that have not been shown; otherwise false.
+             */
+            auto setBackgroundCrawl(bool isBackgroundCrawl) -> void;
+
+            /**
+             * @brief       Returns whether pages that have not been shown are crawled for search content.
+             *
+             * @returns     true if background crawling is enabled; otherwise false.
+             */
+            auto isBackgroundCrawl() -> bool;
+
+            /**
+             * @brief       Sets whether changes are applied as they are made.
+             *
+             * @details     In live apply mode each page is validated and applied shortly after it reports a
+             *              change, bursts of changes to a page are applied once.  The Apply and Cancel buttons are
+             *              hidden and the OK button closes the dialog once any pending changes have been applied.
+             *
+             * @param[in]   isLiveApply true to apply changes as they are made; otherwise false.
+             */
+            auto setLiveApply(bool isLiveApply) -> void;
+
+            /**
+             * @brief       Returns whether changes are applied as they are made.
+             *
+             * @returns     true if live apply is enabled; otherwise false.
+             */
+            auto isLiveApply() -> bool;
+
+            /**
+             * @brief       Undoes the most recent edit to a setting.
+             *
+             * @details     The page of the setting is shown and the old value is set with
+             *              ISettingsPage::setSettingValue().  This is bound to the standard undo shortcut.
+             */
+            auto undo() -> void;
+
+            /**
+             * @brief       Redoes the most recently undone edit to a setting.
+             *
+             * @details     This is bound to the standard redo shortcut.
+             */
+            auto redo() -> void;
+
             /**
              * @brief       This signal is emitted when the window is closed by the user.
              */
             Q_SIGNAL void closed();
 
+            /**
+             * @brief       This signal is emitted when the changed settings have been applied.
+             *
+             * @details     This is emitted for the OK and Apply buttons and for live apply.  On Windows and Linux the
+             *              settings are applied in the background, so this is emitted once the apply pipeline has
+             *              finished rather than when the button is pressed.
+             *
+             * @param[in]   isApplied true if every changed page was applied and saved; otherwise false.
+             */
+            Q_SIGNAL void settingsApplied(bool isApplied);
+
         protected:
             /**
              * @brief       Reimplements: QWidget::closeEvent(QCloseEvent *event).
@@ -131,6 +317,37 @@ namespace Nedrysoft { namespace SettingsDialog {
              */
             auto closeEvent(QCloseEvent *event) -> void override;
 
+            /**
+             * @brief       Reimplements: QWidget::showEvent(QShowEvent *event).
+             *
+             * @param[in]   event the event information.
+             */
+            auto showEvent(QShowEvent *event) -> void override;
+
+            /**
+             * @brief       Reimplements: QWidget::hideEvent(QHideEvent *event).
+             *
+             * @param[in]   event the event information.
+             */
+            auto hideEvent(QHideEvent *event) -> void override;
+
+            /**
+             * @brief       Reimplements: QWidget::changeEvent(QEvent *event).
+             *
+             * @param[in]   event the event information.
+             */
+            auto changeEvent(QEvent *event) -> void override;
+
+            /**
+             * @brief       Reimplements: QObject::eventFilter(QObject *watched, QEvent *event).
+             *
+             * @param[in]   watched the object that the event is for.
+             * @param[in]   event the event information.
+             *
+             * @returns     true if the event was handled; otherwise false.
+             */
+            auto eventFilter(QObject *watched, QEvent *event) -> bool override;
+
             /**
              * @brief       Returns the recommended size for the widget.
              *
@@ -153,12 +370,49 @@ namespace Nedrysoft { namespace SettingsDialog {
              */
             auto okToClose() -> bool;
 
+            /**
+             * @brief       The result of acceptSettings().
+             */
+            enum class AcceptStatus {
+                Invalid,
+                Failed,
+                Applied,
+                Started
+            };
+
             /**
              * @brief       Accept all settings that have been modified.
              *
-             * @returns     true if settings were accepted; otherwise false.
+             * @details     On Windows and Linux the settings are validated and then applied by the apply pipeline,
+             *              the buttons are disabled until the pipeline finishes.  The outcome of an apply that was
+             *              started is reported by settingsApplied().
+             *
+             * @returns     Invalid if a page failed validation, Failed if the settings could not be saved, Applied
+             *              if the settings were applied and saved or Started if they are being applied.
+             */
+            auto acceptSettings() -> AcceptStatus;
+
+            /**
+             * @brief       Returns the pages that are shown by the current navigation selection.
+             *
+             * @returns     the list of pages.
              */
-            auto acceptSettings() -> bool;
+            auto currentPages() -> QList<ISettingsPage *>;
+
+            /**
+             * @brief       Notifies pages that have become visible or hidden.
+             *
+             * @details     Pages in the list that were not previously visible receive pageShown(), previously
+             *              visible pages that are not in the list receive pageHidden().
+             *
+             * @param[in]   pages the pages that are now visible.
+             */
+            auto setVisiblePages(const QList<ISettingsPage *> &pages) -> void;
+
+            /**
+             * @brief       Updates the visible pages after the navigation selection has changed.
+             */
+            auto updateVisiblePages() -> void;
 
         protected:
             /**
@@ -168,14 +422,35 @@ namespace Nedrysoft { namespace SettingsDialog {
              */
             auto resizeEvent(QResizeEvent *event) -> void override;
 
+            /**
+             * @brief       Sorts and adds a list of pages to the settings dialog.
+             *
+             * @details     The pages of each batch are sorted, then each section and page is inserted at its sorted
+             *              position among the pages that were added by earlier batches.
+             *
+             * @param[in]   descriptors the descriptors of the pages.
+             * @param[in]   pages the pages in the same order as the descriptors, or an empty list if the pages are
+             *              to be created by the resolver.
+             * @param[in]   resolver the function that creates a page from its descriptor.
+             */
+            auto insertPages(
+                    const QList<SettingsPageDescriptor> &descriptors,
+                    const QList<ISettingsPage *> &pages,
+                    const SettingsPageResolver &resolver) -> void;
+
             /**
              * @brief       Adds a setting page to the settings dialog.
              *
-             * @param[in]   page is a ISettingsPage instance.
+             * @param[in]   descriptor the descriptor of the page.
+             * @param[in]   page is a ISettingsPage instance, or nullptr if the page has not been created yet.
+             * @param[in]   resolver the function that creates the page from its descriptor.
              *
              * @returns     the settings page structure
              */
-            auto addPage(ISettingsPage *page) -> SettingsPage *;
+            auto addPage(
+                    const SettingsPageDescriptor &descriptor,
+                    ISettingsPage *page,
+                    const SettingsPageResolver &resolver) -> SettingsPage *;
 
             /**
              * @brief       Updates the stylesheet for light/dark mode.
@@ -192,6 +467,305 @@ namespace Nedrysoft { namespace SettingsDialog {
              */
             auto updateTitlebar() -> void;
 
+#if defined(Q_OS_MACOS)
+            /**
+             * @brief       Selects a section, animating the transition from the current section.
+             *
+             * @param[in]   settingsPage the section to select.
+             */
+            auto selectSection(SettingsPage *settingsPage) -> void;
+#endif
+
+#if !defined(Q_OS_MACOS)
+            /**
+             * @brief       Updates the width of the navigation tree to fit the widest section name.
+             */
+            auto updateNavigationWidth() -> void;
+
+            /**
+             * @brief       Creates the container for a section and inserts it into the stacked widget.
+             *
+             * @param[in]   section the section to build.
+             */
+            auto buildSection(SettingsSection *section) -> void;
+
+            /**
+             * @brief       Adds a tab for a page to a tabbed section.
+             *
+             * @param[in]   section the section containing the tab widget.
+             * @param[in]   settingsPage the page to add.
+             * @param[in]   index the position of the tab, or -1 to add it after the existing tabs.
+             */
+            auto addSectionTab(SettingsSection *section, SettingsPage *settingsPage, int index=-1) -> void;
+
+            /**
+             * @brief       Returns the position in a section that a new page is inserted at.
+             *
+             * @details     A page is placed with the other pages of its category in weight order, a page with a
+             *              new category is placed before the first category with a higher weight.  Pages that are
+             *              already in the section are reordered afterwards by sortSectionPages().
+             *
+             * @param[in]   section the section that the page is added to.
+             * @param[in]   settingsPage the page being added.
+             *
+             * @returns     the index in the pages of the section.
+             */
+            auto sectionPosition(SettingsSection *section, SettingsPage *settingsPage) -> int;
+
+            /**
+             * @brief       Orders the categories of a section by the lowest weight of the pages that they contain.
+             *
+             * @details     A page added by a later batch can lower the weight of an existing category, the pages
+             *              and the tabs of the category are moved to keep the section in order.
+             *
+             * @param[in]   section the section.
+             */
+            auto sortSectionPages(SettingsSection *section) -> void;
+
+            /**
+             * @brief       Returns the position in the navigation tree of the item of a section.
+             *
+             * @details     The item is placed after the sections with the same or a lower weight, the item of the
+             *              section itself is ignored.
+             *
+             * @param[in]   section the section.
+             *
+             * @returns     the index of the top level item.
+             */
+            auto sectionItemPosition(SettingsSection *section) -> int;
+
+            /**
+             * @brief       Creates the tab widget for a section with multiple categories.
+             *
+             * @param[in]   section the section that the tab widget belongs to.
+             */
+            auto createSectionTabWidget(SettingsSection *section) -> void;
+
+            /**
+             * @brief       Creates the content of a tab if it has not yet been created.
+             *
+             * @param[in]   section the section containing the tab.
+             * @param[in]   index the index of the tab.
+             */
+            auto loadSectionTab(SettingsSection *section, int index) -> void;
+
+            /**
+             * @brief       Hides the sections that do not contain one of the current search results.
+             *
+             * @param[in]   text the search text, if empty then all sections are shown.
+             */
+            auto filterNavigation(const QString &text) -> void;
+
+            /**
+             * @brief       Ranks the pages for the search text and updates the navigation and prefetch.
+             *
+             * @param[in]   text the search text.
+             */
+            auto updateSearchResults(const QString &text) -> void;
+
+            /**
+             * @brief       Returns the pages that match the search text ordered by relevance.
+             *
+             * @details     The prefix index is consulted first, if it has no matches then the pages are fuzzy
+             *              matched so that misspelt searches still find results.
+             *
+             * @param[in]   text the search text.
+             *
+             * @returns     the indexes of the matching pages, best match first.
+             */
+            auto rankedPages(const QString &text) -> QVector<int>;
+
+            /**
+             * @brief       Adds the widget content of a page to the search index.
+             *
+             * @details     If the content cache holds the content of the page or the page provides its option text
+             *              then it is used directly, otherwise the widget of the page is queued to be crawled in the
+             *              background once the dialog has created it, or straight away if background crawling is
+             *              enabled.
+             *
+             * @param[in]   settingsPage the page to index.
+             */
+            auto indexPageContent(SettingsPage *settingsPage) -> void;
+
+            /**
+             * @brief       Adds content items to the search index entries of a page.
+             *
+             * @param[in]   settingsPage the page.
+             * @param[in]   items the content items of the page.
+             */
+            auto setPageContent(SettingsPage *settingsPage, const QList<SearchContentItem> &items) -> void;
+
+            /**
+             * @brief       Crawls the widget of the next page in the content queue.
+             */
+            auto crawlNextPageContent() -> void;
+
+            /**
+             * @brief       Updates the search index after pages have been added.
+             *
+             * @details     If the index file on disk was built for the current set of pages then it is mapped and
+             *              used directly, otherwise the content of the pages is indexed in memory and the index file
+             *              is rebuilt once all content is known.  This is deferred until no further batch of pages
+             *              has been added for a short time, or until the next search.
+             */
+            auto updateSearchIndex() -> void;
+
+            /**
+             * @brief       Writes the index file for the current set of pages.
+             */
+            auto writeSearchIndex() -> void;
+
+            /**
+             * @brief       Shows a page, selecting its section and category.
+             *
+             * @param[in]   settingsPage the page to show.
+             */
+            auto showPage(SettingsPage *settingsPage) -> void;
+
+            /**
+             * @brief       Returns the page that is shown when a section is selected.
+             *
+             * @param[in]   section the section.
+             *
+             * @returns     the page of the current tab, or the first page if the section has not been built.
+             */
+            auto sectionPage(SettingsSection *section) -> SettingsPage *;
+
+            /**
+             * @brief       Creates the widget of a page without showing it.
+             *
+             * @param[in]   settingsPage the page to prefetch.
+             */
+            auto prefetchPage(SettingsPage *settingsPage) -> void;
+
+            /**
+             * @brief       Records that a page is about to be shown and creates it if required.
+             *
+             * @param[in]   settingsPage the page being shown.
+             */
+            auto loadShownPage(SettingsPage *settingsPage) -> void;
+
+            /**
+             * @brief       Returns the page instance, creating it with the resolver if required.
+             *
+             * @param[in]   settingsPage the page.
+             *
+             * @returns     the page instance if it exists or could be created; otherwise nullptr.
+             */
+            auto resolvePage(SettingsPage *settingsPage) -> ISettingsPage *;
+
+            /**
+             * @brief       Creates the widget for a page.
+             *
+             * @param[in]   settingsPage the page.
+             *
+             * @returns     the page widget, or a placeholder if the page could not be created.
+             */
+            auto createPageWidget(SettingsPage *settingsPage) -> QWidget *;
+
+            /**
+             * @brief       Restores the buttons once the apply pipeline has finished.
+             *
+             * @details     If a page failed to apply then it is shown, otherwise the dialog is closed if the
+             *              settings were applied with the OK button.
+             *
+             * @param[in]   isApplied true if every page was applied; otherwise false.
+             */
+            auto applyFinished(bool isApplied) -> void;
+
+            /**
+             * @brief       Marks the navigation tree item and tab of a page as valid or invalid.
+             *
+             * @param[in]   page the page whose validity changed.
+             * @param[in]   isValid true if the page is valid; otherwise false.
+             */
+            auto markPageValidity(ISettingsPage *page, bool isValid) -> void;
+
+            /**
+             * @brief       Updates the tab marker of a page from its validity.
+             *
+             * @param[in]   settingsPage the page.
+             */
+            auto updateTabValidity(SettingsPage *settingsPage) -> void;
+#endif
+
+            /**
+             * @brief       Returns the first page that prevents the settings from being accepted.
+             *
+             * @details     The pages are checked with the validation cache, then the constraints of every page
+             *              in the constraint registry are checked.
+             *
+             * @param[in]   pages the pages whose widgets have been created.
+             *
+             * @returns     the first invalid page if any; otherwise nullptr.
+             */
+            auto firstInvalidPage(const QList<ISettingsPage *> &pages) -> ISettingsPage *;
+
+            /**
+             * @brief       Shows the page of a settings page instance.
+             *
+             * @param[in]   page the page to show.
+             */
+            auto showPageFor(ISettingsPage *page) -> void;
+
+            /**
+             * @brief       Connects the signals of a page and registers its constraints.
+             *
+             * @param[in]   page the page.
+             */
+            auto connectPage(ISettingsPage *page) -> void;
+
+            /**
+             * @brief       Sets a setting of a page to a value recorded in the journal.
+             *
+             * @param[in]   page the page.
+             * @param[in]   key the key of the setting.
+             * @param[in]   value the value to set.
+             */
+            auto replaySettingValue(ISettingsPage *page, const QString &key, const QVariant &value) -> void;
+
+            /**
+             * @brief       Called when the settings of a page have been changed by the user.
+             *
+             * @param[in]   page the page that changed.
+             */
+            auto pageSettingsChanged(ISettingsPage *page) -> void;
+
+            /**
+             * @brief       Validates and applies the pages queued by live apply.
+             *
+             * @details     Pages that are not valid are not applied, they are applied after their next change.
+             *
+             * @returns     true if the pages are being applied in the background and the apply pipeline will finish
+             *              later; otherwise false.
+             */
+            auto startLiveApply() -> bool;
+
+            /**
+             * @brief       Returns the pages that need to be applied.
+             *
+             * @details     Pages whose values have not changed since they were captured are left out, the changes
+             *              of the other pages are passed to the page and kept until commitChanges() is called.
+             *
+             * @param[in]   pages the pages to check.
+             *
+             * @returns     the pages that have changed or that do not report their values.
+             */
+            auto changedPages(const QList<ISettingsPage *> &pages) -> QList<ISettingsPage *>;
+
+            /**
+             * @brief       Writes the changes of the applied pages to the settings store and publishes the schema.
+             */
+            auto commitChanges() -> void;
+
+            /**
+             * @brief       Queues the pages whose live apply timer is still running and applies them.
+             *
+             * @returns     true if the pages are being applied in the background and the apply pipeline will finish
+             *              later; otherwise false.
+             */
+            auto applyPendingLiveChanges() -> bool;
+
         private:
             //! @cond
 
@@ -206,6 +780,8 @@ namespace Nedrysoft { namespace SettingsDialog {
             QVBoxLayout *m_detailLayout;
             QHBoxLayout *m_mainLayout;
             QHBoxLayout *m_controlsLayout;
+            QVBoxLayout *m_navigationLayout;
+            QLineEdit *m_searchEdit;
             QTreeWidget *m_treeWidget;
             QStackedWidget *m_stackedWidget;
             QLabel *m_categoryLabel;
@@ -213,8 +789,39 @@ namespace Nedrysoft { namespace SettingsDialog {
             QPushButton *m_cancelButton;
             QPushButton *m_applyButton;
             QList<SettingsPage *> m_pages;
+            QMap<QString, SettingsSection *> m_sections;
+            QMap<QTreeWidgetItem *, SettingsSection *> m_sectionItems;
+            SearchIndex *m_searchIndex;
+            MappedSearchIndex *m_mappedIndex;
+            quint64 m_searchIndexKey;
+            QVector<int> m_searchResults;
+            int m_contentIndexCount;
+            SearchContentCache *m_contentCache;
+            bool m_isContentCacheLoaded;
+            QList<SettingsPage *> m_pendingContent;
+            QTimer *m_contentTimer;
+            QTimer *m_searchIndexTimer;
+            PrefetchPolicy *m_prefetchPolicy;
+            int m_deferredContentCount;
+            bool m_isBackgroundCrawl;
+            ApplyPipeline *m_applyPipeline;
+            QProgressBar *m_progressBar;
+            bool m_isClosingAfterApply;
+            bool m_hasPendingChanges;
+            QSet<ISettingsPage *> m_invalidPages;
 #endif
             SettingsPage *m_currentPage;
+            QList<ISettingsPage *> m_visiblePages;
+            QHash<ISettingsPage *, QTimer *> m_liveApplyTimers;
+            QList<ISettingsPage *> m_liveApplyQueue;
+            bool m_isLiveApply;
+            ValidationCache *m_validationCache;
+            ConstraintRegistry *m_constraintRegistry;
+            SettingsSnapshot *m_settingsSnapshot;
+            QHash<ISettingsPage *, QVariantMap> m_pendingChanges;
+            QHash<ISettingsPage *, QVariantMap> m_editedValues;
+            SettingsJournal *m_journal;
+            bool m_isReplayingJournal;
 
             //! @endcond
     };
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SettingsJournal.h"
+
+Nedrysoft::SettingsDialog::SettingsJournal::SettingsJournal(int capacity) :
+        m_entries(qMax(capacity, 1)),
+        m_first(0),
+        m_count(0),
+        m_position(0) {
+
+}
+
+auto Nedrysoft::SettingsDialog::SettingsJournal::record(
+        ISettingsPage *page,
+        const QString &key,
+        const QVariant &oldValue,
+        const QVariant &newValue) -> void {
+
+    if (oldValue==newValue) {
+        return;
+    }
+
+    // edits that were undone can no longer be redone
+
+    m_count = m_position;
+
+    if (m_position) {
+        auto &lastEntry = entry(m_position-1);
+
+        if ((lastEntry.m_page==page) && (lastEntry.m_key==key)) {
+            lastEntry.m_newValue = newValue;
+
+            if (lastEntry.m_oldValue==lastEntry.m_newValue) {
+                m_count--;
+                m_position--;
+            }
+
+            return;
+        }
+    }
+
+    if (m_count==m_entries.count()) {
+        m_first = (m_first+1)%m_entries.count();
+        m_count--;
+        m_position--;
+    }
+
+    auto &newEntry = entry(m_count);
+
+    newEntry.m_page = page;
+    newEntry.m_key = key;
+    newEntry.m_oldValue = oldValue;
+    newEntry.m_newValue = newValue;
+
+    m_count++;
+    m_position++;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsJournal::canUndo() -> bool {
+    return m_position>0;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsJournal::canRedo() -> bool {
+    return m_position<m_count;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsJournal::undo() -> Nedrysoft::SettingsDialog::SettingsJournalEntry {
+    m_position--;
+
+    return entry(m_position);
+}
+
+auto Nedrysoft::SettingsDialog::SettingsJournal::redo() -> Nedrysoft::SettingsDialog::SettingsJournalEntry {
+    m_position++;
+
+    return entry(m_position-1);
+}
+
+auto Nedrysoft::SettingsDialog::SettingsJournal::clear() -> void {
+    m_first = 0;
+    m_count = 0;
+    m_position = 0;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsJournal::entry(
+        int index) -> Nedrysoft::SettingsDialog::SettingsJournalEntry & {
+
+    return m_entries[(m_first+index)%m_entries.count()];
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_SETTINGSJOURNAL_H
+#define NEDRYSOFT_SETTINGSJOURNAL_H
+
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+namespace Nedrysoft { namespace SettingsDialog {
+    class ISettingsPage;
+
+    /**
+     * @brief       The SettingsJournalEntry class describes an edit to a setting.
+     */
+    class SettingsJournalEntry {
+        public:
+            //! @cond
+
+            ISettingsPage *m_page;
+            QString m_key;
+            QVariant m_oldValue;
+            QVariant m_newValue;
+
+            //! @endcond
+    };
+
+    /**
+     * @brief       The SettingsJournal class records the edits made to settings so that they can be undone.
+     *
+     * @details     The entries are held in a ring buffer of a fixed capacity, once full the oldest edit is
+     *              overwritten.  Consecutive edits to the same key are combined into a single entry, so dragging a
+     *              slider or typing into a field uses one entry, and an entry that returns a key to its old value
+     *              is removed.  Recording an edit discards the edits that were undone.
+     */
+    class SettingsJournal {
+        public:
+            /**
+             * @brief       Constructs a new empty SettingsJournal.
+             *
+             * @param[in]   capacity the maximum number of entries.
+             */
+            explicit SettingsJournal(int capacity=256);
+
+            /**
+             * @brief       Records an edit.
+             *
+             * @param[in]   page the page that the setting belongs to.
+             * @param[in]   key the key of the setting.
+             * @param[in]   oldValue the value before the edit.
+             * @param[in]   newValue the value after the edit.
+             */
+            auto record(
+                    ISettingsPage *page,
+                    const QString &key,
+                    const QVariant &oldValue,
+                    const QVariant &newValue) -> void;
+
+            /**
+             * @brief       Returns whether there is an edit that can be undone.
+             *
+             * @returns     true if an edit can be undone; otherwise false.
+             */
+            auto canUndo() -> bool;
+
+            /**
+             * @brief       Returns whether there is an edit that can be redone.
+             *
+             * @returns     true if an edit can be redone; otherwise false.
+             */
+            auto canRedo() -> bool;
+
+            /**
+             * @brief       Moves back past the most recent edit.
+             *
+             * @note        canUndo() must return true.
+             *
+             * @returns     the edit to undo, the setting should be set to its old value.
+             */
+            auto undo() -> SettingsJournalEntry;
+
+            /**
+             * @brief       Moves forward past the most recently undone edit.
+             *
+             * @note        canRedo() must return true.
+             *
+             * @returns     the edit to redo, the setting should be set to its new value.
+             */
+            auto redo() -> SettingsJournalEntry;
+
+            /**
+             * @brief       Removes all entries.
+             */
+            auto clear() -> void;
+
+        private:
+            /**
+             * @brief       Returns an entry.
+             *
+             * @param[in]   index the index of the entry from the oldest entry.
+             *
+             * @returns     the entry.
+             */
+            auto entry(int index) -> SettingsJournalEntry &;
+
+        private:
+            //! @cond
+
+            QVector<SettingsJournalEntry> m_entries;
+            int m_first;
+            int m_count;
+            int m_position;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_SETTINGSJOURNAL_H
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_SETTINGSKEY_H
+#define NEDRYSOFT_SETTINGSKEY_H
+
+#include "SettingsPublisher.h"
+#include "SettingsSchema.h"
+
+#include <QMetaType>
+#include <QString>
+#include <QVariant>
+
+namespace Nedrysoft { namespace SettingsDialog {
+    /**
+     * @brief       The SettingsKey class declares a setting with its type.
+     *
+     * @details     Keys are declared as static objects, the constructor is constexpr so the hash of the key is
+     *              computed at compile time.  A key is bound to its slot in the SettingsSchema once at startup,
+     *              either by registering the setting or with resolve(), after which reading the value is an
+     *              array index with no hashing or string comparison.
+     *
+     *              The key can be used wherever the dialog uses string keys, such as in the values returned by
+     *              ISettingsPage::settingsSnapshot().
+     *
+     * @tparam      T the type of the setting.
+     */
+    template<typename T>
+    class SettingsKey {
+        public:
+            /**
+             * @brief       Constructs a new SettingsKey.
+             *
+             * @param[in]   key the UTF-8 key of the setting, which must remain valid for the lifetime of the key.
+             */
+            constexpr explicit SettingsKey(const char *key) :
+                    m_key(key),
+                    m_hash(SettingsSchema::hash(key)),
+                    m_id(-1) {
+
+            }
+
+            /**
+             * @brief       Returns the key of the setting.
+             *
+             * @returns     the key.
+             */
+            auto key() const -> QString {
+                return QString::fromUtf8(m_key);
+            }
+
+            /**
+             * @brief       Returns the hash of the key.
+             *
+             * @returns     the hash.
+             */
+            constexpr auto hash() const -> quint64 {
+                return m_hash;
+            }
+
+            /**
+             * @brief       Registers the setting with the schema and binds the key to it.
+             *
+             * @param[in]   defaultValue the value used if the setting has not been stored.
+             * @param[in]   section the section of the page that edits the setting.
+             * @param[in]   category the category of the page that edits the setting.
+             * @param[in]   minimum the minimum of a numeric setting, or an invalid value if there is none.
+             * @param[in]   maximum the maximum of a numeric setting, or an invalid value if there is none.
+             *
+             * @returns     the id of the setting, or -1 if it could not be registered.
+             */
+            auto registerSetting(
+                    const T &defaultValue,
+                    const QString &section,
+                    const QString &category,
+                    const QVariant &minimum=QVariant(),
+                    const QVariant &maximum=QVariant()) -> int {
+
+                SettingDefinition definition;
+
+                definition.m_key = key();
+                definition.m_type = qMetaTypeId<T>();
+                definition.m_defaultValue = QVariant::fromValue(defaultValue);
+                definition.m_minimum = minimum;
+                definition.m_maximum = maximum;
+                definition.m_section = section;
+                definition.m_category = category;
+
+                m_id = SettingsSchema::getInstance()->registerSetting(definition);
+
+                return m_id;
+            }
+
+            /**
+             * @brief       Binds the key to a setting registered elsewhere.
+             *
+             * @returns     true if the setting is registered; otherwise false.
+             */
+            auto resolve() -> bool {
+                auto schema = SettingsSchema::getInstance();
+
+                m_id = schema->id(m_hash);
+
+                // colliding hashes are rejected when a setting is registered, so a setting found by hash with a
+                // different key means that this key has not been registered.
+
+                if ((m_id!=-1) && (schema->definition(m_id).m_key!=key())) {
+                    m_id = -1;
+                }
+
+                return m_id!=-1;
+            }
+
+            /**
+             * @brief       Returns the value of the setting.
+             *
+             * @returns     the value, or a default constructed value if the key is not bound.
+             */
+            auto value() const -> T {
+                if (m_id<0) {
+                    return T();
+                }
+
+                return SettingsSchema::getInstance()->value(m_id).template value<T>();
+            }
+
+            /**
+             * @brief       Returns the value of the setting from published settings.
+             *
+             * @details     This is used by threads other than the GUI thread, which read the settings through a
+             *              SettingsPublisher::ReadGuard.
+             *
+             * @param[in]   values the published settings.
+             *
+             * @returns     the value, or a default constructed value if the key is not bound or was not published.
+             */
+            auto value(const SettingsPublisher::Values *values) const -> T {
+                if (!values) {
+                    return T();
+                }
+
+                return values->value(m_id).template value<T>();
+            }
+
+            /**
+             * @brief       Sets the value of the setting.
+             *
+             * @param[in]   value the new value.
+             *
+             * @returns     true if the key is bound and the value was allowed; otherwise false.
+             */
+            auto setValue(const T &value) -> bool {
+                if (m_id<0) {
+                    return false;
+                }
+
+                return SettingsSchema::getInstance()->setValue(m_id, QVariant::fromValue(value));
+            }
+
+        private:
+            //! @cond
+
+            const char *m_key;
+            quint64 m_hash;
+            int m_id;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_SETTINGSKEY_H
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SettingsPageDescriptor.h"
+
+#include "ISettingsPage.h"
+
+Nedrysoft::SettingsDialog::SettingsPageDescriptor::SettingsPageDescriptor() :
+        m_weight(0) {
+
+}
+
+Nedrysoft::SettingsDialog::SettingsPageDescriptor::SettingsPageDescriptor(ISettingsPage *page) :
+        m_identifier(page->identifier()),
+        m_version(page->version()),
+        m_section(page->section()),
+        m_category(page->category()),
+        m_description(page->description()),
+        m_keywords(page->keywords()),
+        m_weight(page->weight()),
+        m_icon(page->icon(false)),
+        m_darkIcon(page->icon(true)) {
+
+}
+
+auto Nedrysoft::SettingsDialog::SettingsPageDescriptor::icon(bool isDarkMode) const -> QIcon {
+    if (isDarkMode && !m_darkIcon.isNull()) {
+        return m_darkIcon;
+    }
+
+    return m_icon;
+}
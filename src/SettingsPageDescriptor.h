@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_SETTINGSPAGEDESCRIPTOR_H
+#define NEDRYSOFT_SETTINGSPAGEDESCRIPTOR_H
+
+#include "SettingsDialogSpec.h"
+
+#include <QIcon>
+#include <QString>
+#include <QStringList>
+#include <functional>
+
+namespace Nedrysoft { namespace SettingsDialog {
+    class ISettingsPage;
+
+    /**
+     * @brief       The SettingsPageDescriptor class holds the metadata that is needed to show a page in the
+     *              navigation and search results.
+     *
+     * @details     A descriptor allows the dialog to build its navigation without calling into the plugin that
+     *              provides the page, the page itself is only created when it is first shown or applied.
+     */
+    class SETTINGS_DIALOG_DLLSPEC SettingsPageDescriptor {
+        public:
+            /**
+             * @brief       Constructs a new empty SettingsPageDescriptor.
+             */
+            SettingsPageDescriptor();
+
+            /**
+             * @brief       Constructs a new SettingsPageDescriptor from the metadata of a page.
+             *
+             * @param[in]   page the page to describe.
+             */
+            explicit SettingsPageDescriptor(ISettingsPage *page);
+
+            /**
+             * @brief       Returns the icon for the page.
+             *
+             * @param[in]   isDarkMode set to true to return the dark mode icon; otherwise false.
+             *
+             * @returns     the icon, the light icon is returned if the page has no dark mode icon.
+             */
+            auto icon(bool isDarkMode=false) const -> QIcon;
+
+        public:
+            //! @cond
+
+            QString m_identifier;
+            QString m_version;
+            QString m_section;
+            QString m_category;
+            QString m_description;
+            QStringList m_keywords;
+            int m_weight;
+            QIcon m_icon;
+            QIcon m_darkIcon;
+
+            //! @endcond
+    };
+
+    /**
+     * @brief       The function used to create the page described by a descriptor.
+     *
+     * @details     The resolver is called the first time that the page is needed, it should load the plugin that
+     *              provides the page and return the page, or nullptr if the page could not be created.
+     */
+    using SettingsPageResolver = std::function<ISettingsPage *(const SettingsPageDescriptor &descriptor)>;
+}}
+
+#endif // NEDRYSOFT_SETTINGSPAGEDESCRIPTOR_H
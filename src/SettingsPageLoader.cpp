@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SettingsPageLoader.h"
+
+#include "ISettingsPage.h"
+#include "ISettingsPageProvider.h"
+#include "SettingsPagePlugin.h"
+
+#include <QPluginLoader>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+
+//! @cond
+
+class Nedrysoft::SettingsDialog::SettingsPageLoader::Task :
+        public QRunnable {
+
+    public:
+        Task(SettingsPageLoader *loader, int index, const QString &fileName) :
+                m_loader(loader),
+                m_targetThread(loader->thread()),
+                m_index(index),
+                m_fileName(fileName) {
+
+        }
+
+        auto run() -> void override {
+            QList<ISettingsPage *> pages;
+            QString errorString;
+
+            // the library is loaded, its symbols resolved and its root object constructed on this thread.  A
+            // plugin that has already been loaded returns its existing root object.
+
+            QPluginLoader pluginLoader(m_fileName);
+
+            auto instance = pluginLoader.instance();
+
+            if (!instance) {
+                errorString = pluginLoader.errorString();
+            } else {
+                auto provider = qobject_cast<ISettingsPageProvider *>(instance);
+
+                if (!provider) {
+                    errorString = QString("%1 does not provide settings pages").arg(m_fileName);
+                } else {
+                    auto descriptors = SettingsPagePlugin::metaDataDescriptors(m_fileName);
+
+                    if (descriptors.isEmpty()) {
+                        errorString = QString("%1 does not declare any settings pages").arg(m_fileName);
+                    }
+
+                    for (auto &descriptor : descriptors) {
+                        auto page = provider->createPage(descriptor.m_identifier);
+
+                        if (!page) {
+                            errorString = QString("%1 did not create the settings page %2")
+                                    .arg(m_fileName)
+                                    .arg(descriptor.m_identifier);
+
+                            continue;
+                        }
+
+                        pages.append(page);
+                    }
+                }
+
+                // objects created on this thread are pushed to the thread of the loader, the root object is moved
+                // after the pages have been created so that it can be used as their parent.
+
+                for (auto page : pages) {
+                    if ((page->thread()==QThread::currentThread()) && !page->parent()) {
+                        page->moveToThread(m_targetThread);
+                    }
+                }
+
+                if ((instance->thread()==QThread::currentThread()) && !instance->parent()) {
+                    instance->moveToThread(m_targetThread);
+                }
+            }
+
+            if (!pages.isEmpty()) {
+                errorString.clear();
+            }
+
+            auto loader = m_loader;
+            auto index = m_index;
+
+            QMetaObject::invokeMethod(m_loader, [loader, index, pages, errorString]() {
+                loader->pluginLoaded(index, pages, errorString);
+            }, Qt::QueuedConnection);
+        }
+
+    private:
+        SettingsPageLoader *m_loader;
+        QThread *m_targetThread;
+        int m_index;
+        QString m_fileName;
+};
+
+//! @endcond
+
+Nedrysoft::SettingsDialog::SettingsPageLoader::SettingsPageLoader(QObject *parent) :
+        QObject(parent),
+        m_nextIndex(0) {
+
+    m_threadPool = new QThreadPool(this);
+}
+
+Nedrysoft::SettingsDialog::SettingsPageLoader::~SettingsPageLoader() {
+    // results that arrive after this point are discarded along with the queued calls to this object
+
+    m_threadPool->waitForDone();
+}
+
+auto Nedrysoft::SettingsDialog::SettingsPageLoader::setMaximumThreadCount(int maximumThreadCount) -> void {
+    m_threadPool->setMaxThreadCount(maximumThreadCount);
+}
+
+auto Nedrysoft::SettingsDialog::SettingsPageLoader::load(const QStringList &fileNames) -> void {
+    for (auto &fileName : fileNames) {
+        auto index = static_cast<int>(m_fileNames.count());
+
+        m_fileNames.append(fileName);
+        m_pages.append(QList<ISettingsPage *>());
+        m_errorStrings.append(QString());
+        m_isLoaded.append(false);
+
+        m_threadPool->start(new Task(this, index, fileName));
+    }
+}
+
+auto Nedrysoft::SettingsDialog::SettingsPageLoader::isFinished() -> bool {
+    return m_nextIndex==m_fileNames.count();
+}
+
+auto Nedrysoft::SettingsDialog::SettingsPageLoader::pluginLoaded(
+        int index,
+        const QList<ISettingsPage *> &pages,
+        const QString &errorString) -> void {
+
+    m_pages[index] = pages;
+    m_errorStrings[index] = errorString;
+    m_isLoaded[index] = true;
+
+    // results are held back until every earlier plugin has been delivered so that the order is deterministic
+
+    if (index!=m_nextIndex) {
+        return;
+    }
+
+    while ((m_nextIndex<m_fileNames.count()) && m_isLoaded.at(m_nextIndex)) {
+        auto fileName = m_fileNames.at(m_nextIndex);
+        auto readyPages = m_pages.at(m_nextIndex);
+        auto readyErrorString = m_errorStrings.at(m_nextIndex);
+
+        m_pages[m_nextIndex].clear();
+
+        m_nextIndex++;
+
+        if (readyErrorString.isEmpty()) {
+            Q_EMIT pagesReady(fileName, readyPages);
+        } else {
+            Q_EMIT loadFailed(fileName, readyErrorString);
+        }
+    }
+
+    if (isFinished()) {
+        Q_EMIT finished();
+    }
+}
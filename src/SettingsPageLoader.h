@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_SETTINGSPAGELOADER_H
+#define NEDRYSOFT_SETTINGSPAGELOADER_H
+
+#include "SettingsDialogSpec.h"
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class QThreadPool;
+
+namespace Nedrysoft { namespace SettingsDialog {
+    class ISettingsPage;
+
+    /**
+     * @brief       The SettingsPageLoader class creates the settings pages of plugins in parallel.
+     *
+     * @details     Each plugin is loaded on a worker thread, the library is loaded, its symbols are resolved and
+     *              its root object is constructed there.  The pages that the plugin declares in its metadata are
+     *              then created on the same thread by the ISettingsPageProvider of the plugin.  The root object and
+     *              the pages are moved to the thread of the loader and delivered by pagesReady() in the order that
+     *              the plugins were given, regardless of which finishes first.
+     *              The dialog can be shown straight away and pagesReady() forwarded to SettingsDialog::addPages().
+     *
+     * @note        Plugins are initialised and pages are created on a worker thread, so the root object of the
+     *              plugin, ISettingsPageProvider::createPage() and the page constructors must not create widgets
+     *              or touch other GUI objects.  Plugins are loaded in parallel, so createPage() must also be
+     *              reentrant.
+     */
+    class SETTINGS_DIALOG_DLLSPEC SettingsPageLoader :
+            public QObject {
+
+        private:
+            Q_OBJECT
+
+        public:
+            /**
+             * @brief       Constructs a new SettingsPageLoader.
+             *
+             * @param[in]   parent the owner of the loader.
+             */
+            explicit SettingsPageLoader(QObject *parent=nullptr);
+
+            /**
+             * @brief       Destroys the SettingsPageLoader, waiting for any plugins that are still loading.
+             */
+            ~SettingsPageLoader();
+
+            /**
+             * @brief       Sets the maximum number of plugins that are loaded at the same time.
+             *
+             * @param[in]   maximumThreadCount the number of worker threads.
+             */
+            auto setMaximumThreadCount(int maximumThreadCount) -> void;
+
+            /**
+             * @brief       Starts creating the pages of a list of plugins.
+             *
+             * @details     The plugins are delivered after any plugins from earlier calls.
+             *
+             * @param[in]   fileNames the file names of the plugins.
+             */
+            auto load(const QStringList &fileNames) -> void;
+
+            /**
+             * @brief       Returns whether every plugin has been delivered.
+             *
+             * @returns     true if finished; otherwise false.
+             */
+            auto isFinished() -> bool;
+
+            /**
+             * @brief       Emitted in order as the pages of each plugin become available.
+             *
+             * @param[in]   fileName the file name of the plugin.
+             * @param[in]   pages the pages created by the plugin.
+             */
+            Q_SIGNAL void pagesReady(const QString &fileName, const QList<Nedrysoft::SettingsDialog::ISettingsPage *> &pages);
+
+            /**
+             * @brief       Emitted in order when none of the pages of a plugin could be created.
+             *
+             * @param[in]   fileName the file name of the plugin.
+             * @param[in]   errorString the reason that the pages could not be created.
+             */
+            Q_SIGNAL void loadFailed(const QString &fileName, const QString &errorString);
+
+            /**
+             * @brief       Emitted when every plugin has been delivered.
+             */
+            Q_SIGNAL void finished();
+
+        private:
+            /**
+             * @brief       Stores the result of a plugin and delivers any results that are now in order.
+             *
+             * @param[in]   index the index of the plugin.
+             * @param[in]   pages the pages created by the plugin.
+             * @param[in]   errorString the reason that the plugin could not be loaded, or empty on success.
+             */
+            auto pluginLoaded(int index, const QList<ISettingsPage *> &pages, const QString &errorString) -> void;
+
+        private:
+            //! @cond
+
+            class Task;
+
+            QThreadPool *m_threadPool;
+            QStringList m_fileNames;
+            QVector<QList<ISettingsPage *> > m_pages;
+            QStringList m_errorStrings;
+            QVector<bool> m_isLoaded;
+            int m_nextIndex;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_SETTINGSPAGELOADER_H
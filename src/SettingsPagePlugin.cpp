@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SettingsPagePlugin.h"
+
+#include "ISettingsPageProvider.h"
+#include "PageMetadataCache.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QPluginLoader>
+#include <memory>
+
+constexpr auto MetaDataKey = "MetaData";
+constexpr auto SettingsPagesKey = "SettingsPages";
+constexpr auto PluginVersionKey = "Version";
+
+namespace {
+    Nedrysoft::SettingsDialog::PageMetadataCache *metadataCache = nullptr;
+
+    /**
+     * @brief       Saves the metadata cache if it has been modified, called when the application exits.
+     */
+    auto saveMetadataCache() -> void {
+        if (metadataCache->isModified()) {
+            metadataCache->save(Nedrysoft::SettingsDialog::PageMetadataCache::defaultFileName());
+        }
+
+        delete metadataCache;
+
+        metadataCache = nullptr;
+    }
+}
+
+auto Nedrysoft::SettingsDialog::SettingsPagePlugin::descriptors(
+        const QString &fileName) -> QList<Nedrysoft::SettingsDialog::SettingsPageDescriptor> {
+
+    // the cache is loaded on first use and written back once when the application exits, so the first run
+    // reads the metadata of each plugin and later runs use the stored descriptors until a plugin file changes.
+
+    if (!metadataCache) {
+        metadataCache = new PageMetadataCache;
+
+        metadataCache->load(PageMetadataCache::defaultFileName());
+
+        qAddPostRoutine(saveMetadataCache);
+    }
+
+    if (metadataCache->contains(fileName)) {
+        return metadataCache->descriptors(fileName);
+    }
+
+    auto descriptors = metaDataDescriptors(fileName);
+
+    metadataCache->setDescriptors(fileName, descriptors);
+
+    return descriptors;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsPagePlugin::metaDataDescriptors(
+        const QString &fileName) -> QList<Nedrysoft::SettingsDialog::SettingsPageDescriptor> {
+
+    QList<SettingsPageDescriptor> descriptors;
+
+    // the metadata is read from the plugin file without loading the library
+
+    auto metaData = QPluginLoader(fileName).metaData().value(MetaDataKey).toObject();
+    auto directory = QFileInfo(fileName).absolutePath();
+    auto pluginVersion = metaData.value(PluginVersionKey).toString();
+
+    for (auto value : metaData.value(SettingsPagesKey).toArray()) {
+        auto object = value.toObject();
+
+        if (object.value("identifier").toString().isEmpty() || object.value("section").toString().isEmpty()) {
+            continue;
+        }
+
+        descriptors.append(descriptor(object, directory, pluginVersion));
+    }
+
+    return descriptors;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsPagePlugin::resolver(
+        const QString &fileName) -> Nedrysoft::SettingsDialog::SettingsPageResolver {
+
+    // the loader is shared by the pages of the plugin, the library is not loaded until one of them is needed.  If
+    // the plugin has already been loaded then QPluginLoader returns the existing root object.
+
+    auto loader = std::make_shared<QPluginLoader>(fileName);
+
+    return [loader](const SettingsPageDescriptor &descriptor) -> ISettingsPage * {
+        auto provider = qobject_cast<ISettingsPageProvider *>(loader->instance());
+
+        if (!provider) {
+            return nullptr;
+        }
+
+        return provider->createPage(descriptor.m_identifier);
+    };
+}
+
+auto Nedrysoft::SettingsDialog::SettingsPagePlugin::descriptor(
+        const QJsonObject &object,
+        const QString &directory,
+        const QString &pluginVersion) -> Nedrysoft::SettingsDialog::SettingsPageDescriptor {
+
+    SettingsPageDescriptor descriptor;
+
+    descriptor.m_identifier = object.value("identifier").toString();
+    descriptor.m_version = object.value("version").toString(pluginVersion);
+    descriptor.m_section = object.value("section").toString();
+    descriptor.m_category = object.value("category").toString();
+    descriptor.m_description = object.value("description").toString();
+    descriptor.m_weight = object.value("weight").toInt();
+
+    for (auto keyword : object.value("keywords").toArray()) {
+        descriptor.m_keywords.append(keyword.toString());
+    }
+
+    // QIcon defers reading the file until the icon is painted
+
+    auto iconPath = object.value("icon").toString();
+    auto darkIconPath = object.value("darkIcon").toString();
+
+    if (!iconPath.isEmpty()) {
+        descriptor.m_icon = QIcon(QDir(directory).filePath(iconPath));
+    }
+
+    if (!darkIconPath.isEmpty()) {
+        descriptor.m_darkIcon = QIcon(QDir(directory).filePath(darkIconPath));
+    }
+
+    return descriptor;
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_SETTINGSPAGEPLUGIN_H
+#define NEDRYSOFT_SETTINGSPAGEPLUGIN_H
+
+#include "SettingsDialogSpec.h"
+#include "SettingsPageDescriptor.h"
+
+#include <QList>
+#include <QString>
+
+class QJsonObject;
+
+namespace Nedrysoft { namespace SettingsDialog {
+    /**
+     * @brief       The SettingsPagePlugin class reads page descriptors from plugin metadata.
+     *
+     * @details     A plugin declares its pages in the "SettingsPages" array of its JSON metadata, for example:
+     *
+     *              {
+     *                  "SettingsPages": [
+     *                      {
+     *                          "identifier": "GeneralSettingsPage",
+     *                          "version": "1",
+     *                          "section": "General",
+     *                          "category": "Appearance",
+     *                          "description": "General application settings",
+     *                          "icon": "icons/general.png",
+     *                          "darkIcon": "icons/general-dark.png",
+     *                          "weight": 0,
+     *                          "keywords": ["theme", "colour"]
+     *                      }
+     *                  ]
+     *              }
+     *
+     *              Icon paths are relative to the directory of the plugin file, as resources inside the plugin
+     *              are not available until it is loaded.  If a page has no version then the "Version" of the
+     *              plugin is used.  The root object of the plugin must implement ISettingsPageProvider.
+     *
+     *              The descriptors of each plugin are passed to SettingsDialog::addPages() together with the
+     *              resolver() of the plugin, so that a plugin is only loaded when one of its pages is first opened
+     *              or applied.
+     */
+    class SETTINGS_DIALOG_DLLSPEC SettingsPagePlugin {
+        public:
+            /**
+             * @brief       Returns the descriptors of the pages that a plugin provides.
+             *
+             * @details     The descriptors are taken from the PageMetadataCache while the plugin file is unchanged,
+             *              otherwise they are read from the metadata of the plugin and stored in the cache.  The
+             *              cache is saved when the application exits.
+             *
+             * @note        The plugin library is not loaded.  This must be called from the GUI thread, as the
+             *              icons of cached descriptors are created from pixmaps.
+             *
+             * @param[in]   fileName the file name of the plugin.
+             *
+             * @returns     the descriptors, or an empty list if the plugin declares no pages.
+             */
+            static auto descriptors(const QString &fileName) -> QList<SettingsPageDescriptor>;
+
+            /**
+             * @brief       Returns the descriptors declared in the metadata of a plugin, bypassing the cache.
+             *
+             * @note        The plugin library is not loaded.  This may be called from any thread.
+             *
+             * @param[in]   fileName the file name of the plugin.
+             *
+             * @returns     the descriptors, or an empty list if the plugin declares no pages.
+             */
+            static auto metaDataDescriptors(const QString &fileName) -> QList<SettingsPageDescriptor>;
+
+            /**
+             * @brief       Returns a resolver that creates the pages of a plugin.
+             *
+             * @details     The plugin is loaded the first time that the resolver is called, the page is then
+             *              created by the ISettingsPageProvider of the plugin.  Only the plugin that provides the
+             *              page is loaded.
+             *
+             * @param[in]   fileName the file name of the plugin.
+             *
+             * @returns     the resolver.
+             */
+            static auto resolver(const QString &fileName) -> SettingsPageResolver;
+
+        private:
+            /**
+             * @brief       Creates a descriptor from a JSON object.
+             *
+             * @param[in]   object the JSON object describing the page.
+             * @param[in]   directory the directory that icon paths are relative to.
+             * @param[in]   pluginVersion the version of the plugin.
+             *
+             * @returns     the descriptor.
+             */
+            static auto descriptor(
+                    const QJsonObject &object,
+                    const QString &directory,
+                    const QString &pluginVersion) -> SettingsPageDescriptor;
+    };
+}}
+
+#endif // NEDRYSOFT_SETTINGSPAGEPLUGIN_H
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SettingsPublisher.h"
+
+#include "SettingsSchema.h"
+
+#include <limits>
+
+//! @cond
+
+class Nedrysoft::SettingsDialog::SettingsPublisher::ReaderSlot {
+    public:
+        ReaderSlot() :
+                m_index(-1),
+                m_depth(0),
+                m_isLocked(false) {
+
+        }
+
+        ~ReaderSlot() {
+            if (m_index>=0) {
+                auto publisher = SettingsPublisher::getInstance();
+
+                publisher->m_readerEpochs[m_index].store(0);
+                publisher->m_isSlotUsed[m_index].store(false);
+            }
+        }
+
+        auto acquire() -> bool {
+            if (m_index>=0) {
+                return true;
+            }
+
+            auto publisher = SettingsPublisher::getInstance();
+
+            for (auto index=0;index<MaximumReaders;index++) {
+                auto isUsed = false;
+
+                if (publisher->m_isSlotUsed[index].compare_exchange_strong(isUsed, true)) {
+                    m_index = index;
+
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        int m_index;
+        int m_depth;
+        bool m_isLocked;
+};
+
+//! @endcond
+
+Nedrysoft::SettingsDialog::SettingsPublisher::ReadGuard::ReadGuard() {
+    auto publisher = SettingsPublisher::getInstance();
+    auto &slot = SettingsPublisher::readerSlot();
+
+    // a nested guard is already protected by the outer guard of the thread
+
+    if (!slot.m_depth) {
+        if (slot.acquire()) {
+            publisher->m_readerEpochs[slot.m_index].store(publisher->m_epoch.load());
+        } else {
+            publisher->m_mutex.lock();
+
+            slot.m_isLocked = true;
+        }
+    }
+
+    slot.m_depth++;
+
+    m_values = publisher->m_values.load();
+}
+
+Nedrysoft::SettingsDialog::SettingsPublisher::ReadGuard::~ReadGuard() {
+    auto publisher = SettingsPublisher::getInstance();
+    auto &slot = SettingsPublisher::readerSlot();
+
+    if (--slot.m_depth) {
+        return;
+    }
+
+    if (slot.m_isLocked) {
+        slot.m_isLocked = false;
+
+        publisher->m_mutex.unlock();
+    } else {
+        publisher->m_readerEpochs[slot.m_index].store(0);
+    }
+}
+
+Nedrysoft::SettingsDialog::SettingsPublisher::SettingsPublisher() :
+        m_values(nullptr),
+        m_epoch(1) {
+
+    for (auto index=0;index<MaximumReaders;index++) {
+        m_readerEpochs[index].store(0);
+        m_isSlotUsed[index].store(false);
+    }
+}
+
+Nedrysoft::SettingsDialog::SettingsPublisher::~SettingsPublisher() {
+    delete m_values.load();
+
+    for (auto &retiredValues : m_retiredValues) {
+        delete retiredValues.second;
+    }
+}
+
+auto Nedrysoft::SettingsDialog::SettingsPublisher::getInstance() -> Nedrysoft::SettingsDialog::SettingsPublisher * {
+    static SettingsPublisher instance;
+
+    return &instance;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsPublisher::publish() -> void {
+    auto schema = SettingsSchema::getInstance();
+    auto values = new Values;
+
+    values->m_values.reserve(schema->count());
+
+    for (auto id=0;id<schema->count();id++) {
+        values->m_values.append(schema->value(id));
+    }
+
+    // a thread that holds a guard without a reader slot already holds the mutex, locking it again would deadlock.
+    // That guard has no epoch and may still be using the values that are being replaced, so nothing is reclaimed
+    // until a later publication.
+
+    auto isLocked = readerSlot().m_isLocked;
+
+    if (!isLocked) {
+        m_mutex.lock();
+    }
+
+    // readers that recorded an epoch up to and including the current one may hold the previous values, advancing
+    // the epoch means that readers from now on can only see the new values.
+
+    auto previousValues = m_values.exchange(values);
+    auto epoch = m_epoch.fetch_add(1);
+
+    if (previousValues) {
+        m_retiredValues.append(qMakePair(epoch, previousValues));
+    }
+
+    if (!isLocked) {
+        reclaim();
+
+        m_mutex.unlock();
+    }
+}
+
+auto Nedrysoft::SettingsDialog::SettingsPublisher::readerSlot() -> ReaderSlot & {
+    thread_local ReaderSlot slot;
+
+    return slot;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsPublisher::reclaim() -> void {
+    auto oldestEpoch = std::numeric_limits<quint64>::max();
+
+    for (auto index=0;index<MaximumReaders;index++) {
+        auto epoch = m_readerEpochs[index].load();
+
+        if (epoch && (epoch<oldestEpoch)) {
+            oldestEpoch = epoch;
+        }
+    }
+
+    for (auto index=m_retiredValues.count()-1;index>=0;index--) {
+        if (m_retiredValues.at(index).first<oldestEpoch) {
+            delete m_retiredValues.takeAt(index).second;
+        }
+    }
+}
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_SETTINGSPUBLISHER_H
+#define NEDRYSOFT_SETTINGSPUBLISHER_H
+
+#include "SettingsDialogSpec.h"
+
+#include <QList>
+#include <QMutex>
+#include <QPair>
+#include <QVariant>
+#include <QVector>
+#include <atomic>
+
+namespace Nedrysoft { namespace SettingsDialog {
+    /**
+     * @brief       The SettingsPublisher class publishes the settings to other threads.
+     *
+     * @details     Once settings have been registered, and each time the dialog has applied the settings, an
+     *              immutable copy of the values of the SettingsSchema is published, which replaces the previous
+     *              copy with an atomic swap.  Threads read the current copy through a ReadGuard without taking
+     *              a lock.
+     *
+     *              Copies that have been replaced are freed using epoch based reclamation.  A reader records
+     *              the current epoch in a per thread slot while it holds a guard and each publication advances
+     *              the epoch, a replaced copy is freed once no reader holds a guard taken before it was
+     *              replaced.  A thread that cannot be given a slot falls back to holding a mutex for the lifetime
+     *              of its guard.
+     */
+    class SETTINGS_DIALOG_DLLSPEC SettingsPublisher {
+        public:
+            /**
+             * @brief       The Values class is an immutable copy of the settings, indexed by schema id.
+             */
+            class Values {
+                public:
+                    /**
+                     * @brief       Returns the number of settings.
+                     *
+                     * @returns     the number of settings.
+                     */
+                    auto count() const -> int {
+                        return m_values.count();
+                    }
+
+                    /**
+                     * @brief       Returns the value of a setting.
+                     *
+                     * @param[in]   id the schema id of the setting.
+                     *
+                     * @returns     the value, or an invalid value if the setting was registered after the copy
+                     *              was published.
+                     */
+                    auto value(int id) const -> QVariant {
+                        return ((id>=0) && (id<m_values.count())) ? m_values.at(id) : QVariant();
+                    }
+
+                public:
+                    //! @cond
+
+                    QVector<QVariant> m_values;
+
+                    //! @endcond
+            };
+
+            /**
+             * @brief       The ReadGuard class gives a thread access to the published settings.
+             *
+             * @details     The values returned by values() remain valid until the guard is destroyed, guards
+             *              should be short lived so that replaced copies can be freed.  Guards may be nested.
+             */
+            class SETTINGS_DIALOG_DLLSPEC ReadGuard {
+                public:
+                    /**
+                     * @brief       Constructs a new ReadGuard and takes the current published settings.
+                     */
+                    ReadGuard();
+
+                    /**
+                     * @brief       Destroys the ReadGuard.
+                     */
+                    ~ReadGuard();
+
+                    ReadGuard(const ReadGuard &) = delete;
+                    auto operator=(const ReadGuard &) -> ReadGuard & = delete;
+
+                    /**
+                     * @brief       Returns the published settings.
+                     *
+                     * @returns     the settings, or nullptr if no settings have been published yet.
+                     */
+                    auto values() const -> const Values * {
+                        return m_values;
+                    }
+
+                private:
+                    //! @cond
+
+                    const Values *m_values;
+
+                    //! @endcond
+            };
+
+        private:
+            /**
+             * @brief       Constructs the SettingsPublisher with no settings published.
+             */
+            SettingsPublisher();
+
+            /**
+             * @brief       Destroys the SettingsPublisher.
+             */
+            ~SettingsPublisher();
+
+        public:
+            /**
+             * @brief       Returns the shared SettingsPublisher instance.
+             *
+             * @returns     the instance.
+             */
+            static auto getInstance() -> SettingsPublisher *;
+
+            /**
+             * @brief       Publishes the current values of the SettingsSchema.
+             *
+             * @note        This should be called from the GUI thread.  It may be called while the thread holds a
+             *              ReadGuard.
+             */
+            auto publish() -> void;
+
+        private:
+            //! @cond
+
+            class ReaderSlot;
+
+            //! @endcond
+
+            /**
+             * @brief       Returns the reader slot of the calling thread.
+             *
+             * @returns     the slot.
+             */
+            static auto readerSlot() -> ReaderSlot &;
+
+            /**
+             * @brief       Frees the replaced copies that no reader can still be using.
+             *
+             * @note        The caller must hold the mutex.
+             */
+            auto reclaim() -> void;
+
+        private:
+            //! @cond
+
+            static constexpr auto MaximumReaders = 128;
+
+            std::atomic<const Values *> m_values;
+            std::atomic<quint64> m_epoch;
+            std::atomic<quint64> m_readerEpochs[MaximumReaders];
+            std::atomic<bool> m_isSlotUsed[MaximumReaders];
+            QList<QPair<quint64, const Values *> > m_retiredValues;
+            QMutex m_mutex;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_SETTINGSPUBLISHER_H
@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SettingsSchema.h"
+
+#include "SettingsPublisher.h"
+#include "SettingsStore.h"
+
+#include <QCoreApplication>
+
+namespace {
+    /**
+     * @brief       Returns whether a type is numeric, only numeric settings are checked against their range.
+     *
+     * @param[in]   type the meta type id.
+     *
+     * @returns     true if the type is numeric; otherwise false.
+     */
+    auto isNumericType(int type) -> bool {
+        switch (type) {
+            case QMetaType::Int:
+            case QMetaType::UInt:
+            case QMetaType::Long:
+            case QMetaType::ULong:
+            case QMetaType::LongLong:
+            case QMetaType::ULongLong:
+            case QMetaType::Short:
+            case QMetaType::UShort:
+            case QMetaType::Char:
+            case QMetaType::SChar:
+            case QMetaType::UChar:
+            case QMetaType::Float:
+            case QMetaType::Double: {
+                return true;
+            }
+
+            default: {
+                return false;
+            }
+        }
+    }
+}
+
+Nedrysoft::SettingsDialog::SettingDefinition::SettingDefinition() :
+        m_type(QMetaType::UnknownType) {
+
+}
+
+Nedrysoft::SettingsDialog::SettingsSchema::SettingsSchema() :
+        m_isPublishPending(false) {
+
+}
+
+auto Nedrysoft::SettingsDialog::SettingsSchema::getInstance() -> Nedrysoft::SettingsDialog::SettingsSchema * {
+    static SettingsSchema instance;
+
+    return &instance;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsSchema::registerSetting(const SettingDefinition &definition) -> int {
+    auto settingCount = m_definitions.count();
+    auto id = addSetting(definition);
+
+    // settings are usually registered in bursts, so a single publication is made once control returns to the
+    // event loop rather than copying every value for each registration.
+
+    if (m_definitions.count()!=settingCount) {
+        schedulePublish();
+    }
+
+    return id;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsSchema::registerSettings(const QList<SettingDefinition> &definitions) -> QList<int> {
+    auto settingCount = m_definitions.count();
+    QList<int> ids;
+
+    ids.reserve(definitions.count());
+
+    for (auto &definition : definitions) {
+        ids.append(addSetting(definition));
+    }
+
+    if (m_definitions.count()!=settingCount) {
+        publish();
+    }
+
+    return ids;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsSchema::addSetting(const SettingDefinition &definition) -> int {
+    auto existingId = m_ids.constFind(definition.m_key);
+
+    if (existingId!=m_ids.constEnd()) {
+        return existingId.value();
+    }
+
+    // two keys with the same hash cannot both be resolved by hash, so the second key is rejected
+
+    auto keyHash = hash(definition.m_key.toUtf8().constData());
+
+    if (m_hashIds.contains(keyHash)) {
+        Q_ASSERT_X(false, "SettingsSchema::registerSetting", "the hash of the key collides with another key");
+
+        return -1;
+    }
+
+    auto id = m_definitions.count();
+
+    m_definitions.append(definition);
+    m_values.append(QVariant());
+
+    m_ids[definition.m_key] = id;
+    m_hashIds[keyHash] = id;
+
+    m_values[id] = storedValue(id);
+
+    return id;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsSchema::schedulePublish() -> void {
+    if (m_isPublishPending) {
+        return;
+    }
+
+    auto application = QCoreApplication::instance();
+
+    if (!application) {
+        publish();
+
+        return;
+    }
+
+    m_isPublishPending = true;
+
+    QMetaObject::invokeMethod(application, [=]() {
+        if (m_isPublishPending) {
+            publish();
+        }
+    }, Qt::QueuedConnection);
+}
+
+auto Nedrysoft::SettingsDialog::SettingsSchema::publish() -> void {
+    m_isPublishPending = false;
+
+    SettingsPublisher::getInstance()->publish();
+}
+
+auto Nedrysoft::SettingsDialog::SettingsSchema::id(const QString &key) -> int {
+    return m_ids.value(key, -1);
+}
+
+auto Nedrysoft::SettingsDialog::SettingsSchema::id(quint64 hash) -> int {
+    return m_hashIds.value(hash, -1);
+}
+
+auto Nedrysoft::SettingsDialog::SettingsSchema::count() -> int {
+    return m_definitions.count();
+}
+
+auto Nedrysoft::SettingsDialog::SettingsSchema::definition(int id) -> Nedrysoft::SettingsDialog::SettingDefinition {
+    return m_definitions.at(id);
+}
+
+auto Nedrysoft::SettingsDialog::SettingsSchema::settings(
+        const QString &section,
+        const QString &category) -> QList<int> {
+
+    QList<int> ids;
+
+    for (auto id=0;id<m_definitions.count();id++) {
+        auto &definition = m_definitions.at(id);
+
+        if ((definition.m_section==section) && (definition.m_category==category)) {
+            ids.append(id);
+        }
+    }
+
+    return ids;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsSchema::isValid(int id, const QVariant &value) -> bool {
+    QVariant convertedValue;
+
+    return convert(id, value, convertedValue);
+}
+
+auto Nedrysoft::SettingsDialog::SettingsSchema::setValue(int id, const QVariant &value) -> bool {
+    QVariant convertedValue;
+
+    if (!convert(id, value, convertedValue)) {
+        return false;
+    }
+
+    m_values[id] = convertedValue;
+
+    SettingsStore::getInstance()->setValue(m_definitions.at(id).m_key, convertedValue);
+
+    return true;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsSchema::reload() -> void {
+    for (auto id=0;id<m_definitions.count();id++) {
+        m_values[id] = storedValue(id);
+    }
+
+    publish();
+}
+
+auto Nedrysoft::SettingsDialog::SettingsSchema::convert(
+        int id,
+        const QVariant &value,
+        QVariant &convertedValue) -> bool {
+
+    auto &definition = m_definitions.at(id);
+
+    convertedValue = value;
+
+#if (QT_VERSION_MAJOR>5)
+    if (!convertedValue.convert(QMetaType(definition.m_type))) {
+#else
+    if (!convertedValue.convert(definition.m_type)) {
+#endif
+        return false;
+    }
+
+    if (!isNumericType(definition.m_type)) {
+        return true;
+    }
+
+    if (definition.m_minimum.isValid() && (convertedValue.toDouble()<definition.m_minimum.toDouble())) {
+        return false;
+    }
+
+    if (definition.m_maximum.isValid() && (convertedValue.toDouble()>definition.m_maximum.toDouble())) {
+        return false;
+    }
+
+    return true;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsSchema::storedValue(int id) -> QVariant {
+    auto &definition = m_definitions.at(id);
+    auto value = SettingsStore::getInstance()->value(definition.m_key);
+
+    QVariant convertedValue;
+
+    if (value.isValid() && convert(id, value, convertedValue)) {
+        return convertedValue;
+    }
+
+    return definition.m_defaultValue;
+}
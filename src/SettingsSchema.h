@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_SETTINGSSCHEMA_H
+#define NEDRYSOFT_SETTINGSSCHEMA_H
+
+#include "SettingsDialogSpec.h"
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+namespace Nedrysoft { namespace SettingsDialog {
+    /**
+     * @brief       The SettingDefinition class describes a setting registered with the SettingsSchema.
+     */
+    class SETTINGS_DIALOG_DLLSPEC SettingDefinition {
+        public:
+            /**
+             * @brief       Constructs a new SettingDefinition with an unknown type and no range.
+             */
+            SettingDefinition();
+
+        public:
+            //! @cond
+
+            QString m_key;
+            int m_type;
+            QVariant m_defaultValue;
+            QVariant m_minimum;
+            QVariant m_maximum;
+            QString m_section;
+            QString m_category;
+
+            //! @endcond
+    };
+
+    /**
+     * @brief       The SettingsSchema class is a registry of typed settings.
+     *
+     * @details     Each setting is registered with its key, type, default value, optional range and the section
+     *              and category of the page that edits it.  Registering a key interns it and returns an id, the
+     *              values are held in a flat array indexed by id so that reading a setting from a hot path is an
+     *              array index rather than a string lookup.
+     *
+     *              The values are backed by the SettingsStore, the dialog reloads them after each apply so that
+     *              they reflect the values written by the pages.  The values are published with the
+     *              SettingsPublisher whenever they are reloaded, and once after settings have been registered.
+     *
+     * @note        The schema is not thread safe and should be used from the GUI thread.
+     */
+    class SETTINGS_DIALOG_DLLSPEC SettingsSchema {
+        private:
+            /**
+             * @brief       Constructs the SettingsSchema.
+             */
+            SettingsSchema();
+
+        public:
+            /**
+             * @brief       Returns the shared SettingsSchema instance.
+             *
+             * @returns     the instance.
+             */
+            static auto getInstance() -> SettingsSchema *;
+
+            /**
+             * @brief       Registers a setting.
+             *
+             * @details     The value of the setting is read from the SettingsStore, registering a key that is
+             *              already registered returns the existing id.  A key whose hash is the same as the hash
+             *              of a registered key is rejected.
+             *
+             * @note        The new setting is published once control returns to the event loop, so that a burst of
+             *              registrations is published once.  Use registerSettings() to publish straight away.
+             *
+             * @param[in]   definition the setting.
+             *
+             * @returns     the id of the setting, or -1 if the hash of the key collides with another key.
+             */
+            auto registerSetting(const SettingDefinition &definition) -> int;
+
+            /**
+             * @brief       Registers a list of settings and publishes them once.
+             *
+             * @param[in]   definitions the settings.
+             *
+             * @returns     the id of each setting, or -1 for a setting whose key hash collides with another key.
+             */
+            auto registerSettings(const QList<SettingDefinition> &definitions) -> QList<int>;
+
+            /**
+             * @brief       Returns the id of a setting.
+             *
+             * @param[in]   key the key of the setting.
+             *
+             * @returns     the id if the setting is registered; otherwise -1.
+             */
+            auto id(const QString &key) -> int;
+
+            /**
+             * @brief       Returns the id of a setting from the hash of its key.
+             *
+             * @param[in]   hash the hash of the key, as returned by hash().
+             *
+             * @returns     the id if the setting is registered; otherwise -1.
+             */
+            auto id(quint64 hash) -> int;
+
+            /**
+             * @brief       Returns the hash of a key.
+             *
+             * @details     The hash is the 64 bit FNV-1a hash of the UTF-8 key, it can be evaluated at compile time
+             *              so that SettingsKey does not hash at runtime.
+             *
+             * @param[in]   key the UTF-8 key.
+             *
+             * @returns     the hash.
+             */
+            static constexpr auto hash(const char *key) -> quint64 {
+                quint64 keyHash = 0xcbf29ce484222325ULL;
+
+                for (;*key;key++) {
+                    keyHash = (keyHash^static_cast<quint8>(*key))*0x100000001b3ULL;
+                }
+
+                return keyHash;
+            }
+
+            /**
+             * @brief       Returns the number of registered settings.
+             *
+             * @returns     the number of settings.
+             */
+            auto count() -> int;
+
+            /**
+             * @brief       Returns the definition of a setting.
+             *
+             * @param[in]   id the id of the setting.
+             *
+             * @returns     the definition.
+             */
+            auto definition(int id) -> SettingDefinition;
+
+            /**
+             * @brief       Returns the ids of the settings that belong to a page.
+             *
+             * @param[in]   section the section of the page.
+             * @param[in]   category the category of the page.
+             *
+             * @returns     the ids in the order they were registered.
+             */
+            auto settings(const QString &section, const QString &category) -> QList<int>;
+
+            /**
+             * @brief       Returns the value of a setting.
+             *
+             * @param[in]   id the id of the setting.
+             *
+             * @returns     the value.
+             */
+            auto value(int id) -> QVariant {
+                return m_values.at(id);
+            }
+
+            /**
+             * @brief       Returns whether a value is allowed for a setting.
+             *
+             * @details     The value must be convertible to the type of the setting, the range is checked for
+             *              numeric settings.
+             *
+             * @param[in]   id the id of the setting.
+             * @param[in]   value the value.
+             *
+             * @returns     true if the value is allowed; otherwise false.
+             */
+            auto isValid(int id, const QVariant &value) -> bool;
+
+            /**
+             * @brief       Sets the value of a setting.
+             *
+             * @details     The value is converted to the type of the setting and written to the SettingsStore.
+             *
+             * @param[in]   id the id of the setting.
+             * @param[in]   value the new value.
+             *
+             * @returns     true if the value was allowed and set; otherwise false.
+             */
+            auto setValue(int id, const QVariant &value) -> bool;
+
+            /**
+             * @brief       Reads the values of all settings from the SettingsStore and publishes them.
+             */
+            auto reload() -> void;
+
+        private:
+            /**
+             * @brief       Adds a setting without publishing it.
+             *
+             * @param[in]   definition the setting.
+             *
+             * @returns     the id of the setting, or -1 if the hash of the key collides with another key.
+             */
+            auto addSetting(const SettingDefinition &definition) -> int;
+
+            /**
+             * @brief       Publishes the values once control returns to the event loop.
+             *
+             * @details     Further calls before then are merged into the same publication.  The values are
+             *              published straight away if there is no application instance.
+             */
+            auto schedulePublish() -> void;
+
+            /**
+             * @brief       Publishes the values with the SettingsPublisher.
+             */
+            auto publish() -> void;
+
+            /**
+             * @brief       Converts a value to the type of a setting.
+             *
+             * @param[in]   id the id of the setting.
+             * @param[in]   value the value.
+             * @param[out]  convertedValue the converted value.
+             *
+             * @returns     true if the value was converted and is within range; otherwise false.
+             */
+            auto convert(int id, const QVariant &value, QVariant &convertedValue) -> bool;
+
+            /**
+             * @brief       Returns the value of a setting as held in the SettingsStore.
+             *
+             * @param[in]   id the id of the setting.
+             *
+             * @returns     the stored value, or the default value if there is no valid stored value.
+             */
+            auto storedValue(int id) -> QVariant;
+
+        private:
+            //! @cond
+
+            QVector<SettingDefinition> m_definitions;
+            QVector<QVariant> m_values;
+            QHash<QString, int> m_ids;
+            QHash<quint64, int> m_hashIds;
+            bool m_isPublishPending;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_SETTINGSSCHEMA_H
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SettingsSnapshot.h"
+
+#include "ISettingsPage.h"
+
+Nedrysoft::SettingsDialog::SettingsSnapshot::SettingsSnapshot() {
+
+}
+
+auto Nedrysoft::SettingsDialog::SettingsSnapshot::capture(ISettingsPage *page) -> void {
+    if (m_values.contains(page)) {
+        return;
+    }
+
+    auto values = page->settingsSnapshot();
+
+    if (!values.isEmpty()) {
+        m_values[page] = values;
+    }
+}
+
+auto Nedrysoft::SettingsDialog::SettingsSnapshot::contains(ISettingsPage *page) -> bool {
+    return m_values.contains(page);
+}
+
+auto Nedrysoft::SettingsDialog::SettingsSnapshot::changes(ISettingsPage *page) -> QVariantMap {
+    auto capturedValues = m_values.constFind(page);
+
+    if (capturedValues==m_values.constEnd()) {
+        return QVariantMap();
+    }
+
+    auto values = page->settingsSnapshot();
+
+    QVariantMap changedValues;
+
+    // both maps are ordered by key, so the difference is found with a single merge pass
+
+    auto captured = capturedValues->constBegin();
+    auto current = values.constBegin();
+
+    while ((captured!=capturedValues->constEnd()) || (current!=values.constEnd())) {
+        if ((current==values.constEnd()) ||
+            ((captured!=capturedValues->constEnd()) && (captured.key()<current.key()))) {
+
+            changedValues[captured.key()] = QVariant();
+
+            captured++;
+        } else if ((captured==capturedValues->constEnd()) || (current.key()<captured.key())) {
+            changedValues[current.key()] = current.value();
+
+            current++;
+        } else {
+            if (current.value()!=captured.value()) {
+                changedValues[current.key()] = current.value();
+            }
+
+            captured++;
+            current++;
+        }
+    }
+
+    return changedValues;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsSnapshot::update(ISettingsPage *page, const QVariantMap &changes) -> void {
+    auto &values = m_values[page];
+
+    for (auto change=changes.constBegin();change!=changes.constEnd();change++) {
+        if (change.value().isValid()) {
+            values[change.key()] = change.value();
+        } else {
+            values.remove(change.key());
+        }
+    }
+}
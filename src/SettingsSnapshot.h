@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_SETTINGSSNAPSHOT_H
+#define NEDRYSOFT_SETTINGSSNAPSHOT_H
+
+#include <QHash>
+#include <QVariant>
+
+namespace Nedrysoft { namespace SettingsDialog {
+    class ISettingsPage;
+
+    /**
+     * @brief       The SettingsSnapshot class records the settings of each page so that changes can be found.
+     *
+     * @details     The values of a page are captured with ISettingsPage::settingsSnapshot() when the page is
+     *              created, which is before the user can have edited it.  When the settings are accepted the
+     *              current values are compared with the captured ones and only the keys that differ are applied,
+     *              a key that was changed and then changed back is not a change.
+     */
+    class SettingsSnapshot {
+        public:
+            /**
+             * @brief       Constructs a new empty SettingsSnapshot.
+             */
+            SettingsSnapshot();
+
+            /**
+             * @brief       Captures the values of a page if they have not already been captured.
+             *
+             * @param[in]   page the page.
+             */
+            auto capture(ISettingsPage *page) -> void;
+
+            /**
+             * @brief       Returns whether the values of a page have been captured.
+             *
+             * @details     Pages that return an empty snapshot do not report their values and are not captured.
+             *
+             * @param[in]   page the page.
+             *
+             * @returns     true if captured; otherwise false.
+             */
+            auto contains(ISettingsPage *page) -> bool;
+
+            /**
+             * @brief       Returns the values of a page that differ from the captured values.
+             *
+             * @param[in]   page the page.
+             *
+             * @returns     the changed values, a key that has been removed has an invalid value.
+             */
+            auto changes(ISettingsPage *page) -> QVariantMap;
+
+            /**
+             * @brief       Updates the captured values of a page once its changes have been applied.
+             *
+             * @param[in]   page the page.
+             * @param[in]   changes the changes returned by changes().
+             */
+            auto update(ISettingsPage *page, const QVariantMap &changes) -> void;
+
+        private:
+            //! @cond
+
+            QHash<ISettingsPage *, QVariantMap> m_values;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_SETTINGSSNAPSHOT_H
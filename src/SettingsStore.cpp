@@ -0,0 +1,359 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SettingsStore.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+constexpr quint32 StoreMagic = 0x4e535353;
+constexpr quint32 StoreFormatVersion = 1;
+constexpr auto StoreStreamVersion = QDataStream::Qt_5_12;
+constexpr auto StoreFileName = "Settings.dat";
+constexpr quint32 LogMagic = 0x4e53534c;
+constexpr auto LogFileSuffix = ".wal";
+constexpr qint64 LogRecordOverhead = 3*sizeof(quint32);
+constexpr auto CheckpointSize = 64*1024;
+constexpr quint32 ChecksumOffsetBasis = 2166136261u;
+constexpr quint32 ChecksumPrime = 16777619u;
+
+Nedrysoft::SettingsDialog::SettingsStore::SettingsStore() :
+        m_fileName(QDir(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation)).filePath(StoreFileName)),
+        m_logSize(0),
+        m_isLoaded(false),
+        m_isModified(false) {
+
+}
+
+auto Nedrysoft::SettingsDialog::SettingsStore::getInstance() -> Nedrysoft::SettingsDialog::SettingsStore * {
+    static SettingsStore instance;
+
+    return &instance;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsStore::setFileName(const QString &fileName) -> void {
+    QMutexLocker locker(&m_mutex);
+
+    m_fileName = fileName;
+    m_values.clear();
+    m_changedValues.clear();
+    m_removedKeys.clear();
+    m_logSize = 0;
+    m_isLoaded = false;
+    m_isModified = false;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsStore::fileName() -> QString {
+    QMutexLocker locker(&m_mutex);
+
+    return m_fileName;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsStore::value(const QString &key, const QVariant &defaultValue) -> QVariant {
+    QMutexLocker locker(&m_mutex);
+
+    load();
+
+    return m_values.value(key, defaultValue);
+}
+
+auto Nedrysoft::SettingsDialog::SettingsStore::setValue(const QString &key, const QVariant &value) -> void {
+    QMutexLocker locker(&m_mutex);
+
+    load();
+
+    auto entry = m_values.find(key);
+
+    if ((entry!=m_values.end()) && (entry.value()==value)) {
+        return;
+    }
+
+    m_values[key] = value;
+    m_changedValues[key] = value;
+    m_removedKeys.remove(key);
+
+    m_isModified = true;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsStore::remove(const QString &key) -> void {
+    QMutexLocker locker(&m_mutex);
+
+    load();
+
+    if (m_values.remove(key)) {
+        m_changedValues.remove(key);
+        m_removedKeys.insert(key);
+
+        m_isModified = true;
+    }
+}
+
+auto Nedrysoft::SettingsDialog::SettingsStore::contains(const QString &key) -> bool {
+    QMutexLocker locker(&m_mutex);
+
+    load();
+
+    return m_values.contains(key);
+}
+
+auto Nedrysoft::SettingsDialog::SettingsStore::isModified() -> bool {
+    QMutexLocker locker(&m_mutex);
+
+    return m_isModified;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsStore::flush() -> bool {
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_isModified) {
+        return true;
+    }
+
+    QDir().mkpath(QFileInfo(m_fileName).absolutePath());
+
+    QByteArray payload, record;
+    QDataStream payloadStream(&payload, QIODevice::WriteOnly);
+    QDataStream recordStream(&record, QIODevice::WriteOnly);
+
+    payloadStream.setVersion(StoreStreamVersion);
+    recordStream.setVersion(StoreStreamVersion);
+
+    payloadStream << m_changedValues << QStringList(m_removedKeys.values());
+
+    recordStream << LogMagic << static_cast<quint32>(payload.size());
+
+    recordStream.writeRawData(payload.constData(), payload.size());
+
+    recordStream << checksum(payload);
+
+    QFile file(logFileName());
+
+    if (!file.open(QFile::ReadWrite)) {
+        return false;
+    }
+
+    // anything after the last complete record was left by a write that failed and is overwritten
+
+    if ((file.size()!=m_logSize) && !file.resize(m_logSize)) {
+        return false;
+    }
+
+    if (!file.seek(m_logSize) || (file.write(record)!=record.size()) || !syncFile(file)) {
+        return false;
+    }
+
+    file.close();
+
+    m_logSize += record.size();
+
+    m_changedValues.clear();
+    m_removedKeys.clear();
+
+    m_isModified = false;
+
+    // the changes are safely in the log, so a failure to rewrite the settings file only postpones it
+
+    if (m_logSize>=CheckpointSize) {
+        checkpoint();
+    }
+
+    return true;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsStore::load() -> void {
+    if (m_isLoaded) {
+        return;
+    }
+
+    m_isLoaded = true;
+
+    QFile file(m_fileName);
+
+    if (file.open(QFile::ReadOnly)) {
+        QDataStream stream(&file);
+
+        stream.setVersion(StoreStreamVersion);
+
+        quint32 magic = 0, formatVersion = 0;
+        QVariantMap values;
+
+        stream >> magic >> formatVersion;
+
+        if ((magic==StoreMagic) && (formatVersion==StoreFormatVersion)) {
+            stream >> values;
+
+            if (stream.status()==QDataStream::Ok) {
+                m_values = values;
+            }
+        }
+    }
+
+    replayLog();
+}
+
+auto Nedrysoft::SettingsDialog::SettingsStore::replayLog() -> void {
+    m_logSize = 0;
+
+    QFile file(logFileName());
+
+    if (!file.exists() || !file.open(QFile::ReadWrite)) {
+        return;
+    }
+
+    auto data = file.readAll();
+
+    QDataStream stream(data);
+
+    stream.setVersion(StoreStreamVersion);
+
+    while (data.size()-m_logSize>=LogRecordOverhead) {
+        quint32 magic = 0, length = 0, recordChecksum = 0;
+
+        stream >> magic >> length;
+
+        if ((magic!=LogMagic) || (length>data.size()-m_logSize-LogRecordOverhead)) {
+            break;
+        }
+
+        auto payload = data.mid(static_cast<int>(m_logSize+(2*sizeof(quint32))), static_cast<int>(length));
+
+        stream.skipRawData(static_cast<int>(length));
+
+        stream >> recordChecksum;
+
+        if (recordChecksum!=checksum(payload)) {
+            break;
+        }
+
+        QDataStream payloadStream(payload);
+        QVariantMap changedValues;
+        QStringList removedKeys;
+
+        payloadStream.setVersion(StoreStreamVersion);
+
+        payloadStream >> changedValues >> removedKeys;
+
+        if (payloadStream.status()!=QDataStream::Ok) {
+            break;
+        }
+
+        for (auto &key : removedKeys) {
+            m_values.remove(key);
+        }
+
+        for (auto value=changedValues.constBegin();value!=changedValues.constEnd();value++) {
+            m_values[value.key()] = value.value();
+        }
+
+        m_logSize += LogRecordOverhead+length;
+    }
+
+    // a record that is incomplete was being written when the application stopped and is discarded
+
+    if (file.size()>m_logSize) {
+        file.resize(m_logSize);
+    }
+}
+
+auto Nedrysoft::SettingsDialog::SettingsStore::checkpoint() -> bool {
+    QSaveFile file(m_fileName);
+
+    if (!file.open(QFile::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+
+    stream.setVersion(StoreStreamVersion);
+
+    stream << StoreMagic << StoreFormatVersion << m_values;
+
+    if (!file.commit()) {
+        return false;
+    }
+
+    // replaying the log over the new settings file would not change it, so a log that cannot be removed is harmless
+
+    QFile::remove(logFileName());
+
+    m_logSize = 0;
+
+    return true;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsStore::logFileName() -> QString {
+    return m_fileName+LogFileSuffix;
+}
+
+auto Nedrysoft::SettingsDialog::SettingsStore::syncFile(QFile &file) -> bool {
+    if (!file.flush()) {
+        return false;
+    }
+
+#if defined(Q_OS_WIN)
+    // QFile opens the file with a native handle that it does not expose (handle() returns -1), so the file is
+    // flushed through a second handle, which flushes the cached data of the file whichever handle wrote it.
+
+    auto fileName = QDir::toNativeSeparators(file.fileName());
+
+    auto handle = CreateFileW(
+            reinterpret_cast<const wchar_t *>(fileName.utf16()),
+            GENERIC_WRITE,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr);
+
+    if (handle==INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    auto isSynced = (FlushFileBuffers(handle)!=0);
+
+    CloseHandle(handle);
+
+    return isSynced;
+#else
+    return fsync(file.handle())==0;
+#endif
+}
+
+auto Nedrysoft::SettingsDialog::SettingsStore::checksum(const QByteArray &data) -> quint32 {
+    auto hash = ChecksumOffsetBasis;
+
+    for (auto byte : data) {
+        hash = (hash^static_cast<quint8>(byte))*ChecksumPrime;
+    }
+
+    return hash;
+}
@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_SETTINGSSTORE_H
+#define NEDRYSOFT_SETTINGSSTORE_H
+
+#include "SettingsDialogSpec.h"
+
+#include <QMap>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QVariant>
+
+class QFile;
+
+namespace Nedrysoft { namespace SettingsDialog {
+    /**
+     * @brief       The SettingsStore class is a settings backend shared by all settings pages.
+     *
+     * @details     Pages write their values into the store while they are being applied, the values are held in
+     *              memory and the dialog writes them to disk once the apply has finished with flush().  This
+     *              replaces a file rewrite per page with a single write.
+     *
+     *              A flush appends the changes as a single record to a write-ahead log next to the settings file
+     *              and syncs it to disk once, the settings file itself is only rewritten when the log has grown
+     *              large.  When the store is loaded the complete records in the log are replayed over the
+     *              settings file and a record that was only partly written by a crash is discarded, so a flush
+     *              is either fully applied or not at all.
+     *
+     *              The store may be used from the worker thread that background pages are applied on.
+     */
+    class SETTINGS_DIALOG_DLLSPEC SettingsStore {
+        private:
+            /**
+             * @brief       Constructs the SettingsStore.
+             */
+            SettingsStore();
+
+        public:
+            /**
+             * @brief       Returns the shared SettingsStore instance.
+             *
+             * @returns     the instance.
+             */
+            static auto getInstance() -> SettingsStore *;
+
+            /**
+             * @brief       Sets the file that the settings are stored in.
+             *
+             * @note        This should be called before any values are read, values that have not been flushed
+             *              are discarded.
+             *
+             * @param[in]   fileName the file name.
+             */
+            auto setFileName(const QString &fileName) -> void;
+
+            /**
+             * @brief       Returns the file that the settings are stored in.
+             *
+             * @returns     the file name.
+             */
+            auto fileName() -> QString;
+
+            /**
+             * @brief       Returns the value of a setting.
+             *
+             * @param[in]   key the key of the setting.
+             * @param[in]   defaultValue the value returned if the setting does not exist.
+             *
+             * @returns     the value.
+             */
+            auto value(const QString &key, const QVariant &defaultValue=QVariant()) -> QVariant;
+
+            /**
+             * @brief       Sets the value of a setting.
+             *
+             * @param[in]   key the key of the setting.
+             * @param[in]   value the new value.
+             */
+            auto setValue(const QString &key, const QVariant &value) -> void;
+
+            /**
+             * @brief       Removes a setting.
+             *
+             * @param[in]   key the key of the setting.
+             */
+            auto remove(const QString &key) -> void;
+
+            /**
+             * @brief       Checks whether a setting exists.
+             *
+             * @param[in]   key the key of the setting.
+             *
+             * @returns     true if the setting exists; otherwise false.
+             */
+            auto contains(const QString &key) -> bool;
+
+            /**
+             * @brief       Returns whether the store has changes that have not been flushed.
+             *
+             * @returns     true if modified; otherwise false.
+             */
+            auto isModified() -> bool;
+
+            /**
+             * @brief       Writes the changes made since the last flush to the write-ahead log.
+             *
+             * @returns     true if the changes were written or there was nothing to write; otherwise false.
+             */
+            auto flush() -> bool;
+
+        private:
+            /**
+             * @brief       Loads the settings file if it has not been loaded.
+             *
+             * @note        The caller must hold the mutex.
+             */
+            auto load() -> void;
+
+            /**
+             * @brief       Replays the complete records of the write-ahead log and discards an incomplete record.
+             *
+             * @note        The caller must hold the mutex.
+             */
+            auto replayLog() -> void;
+
+            /**
+             * @brief       Writes all settings to the settings file and removes the write-ahead log.
+             *
+             * @details     The file is written to a temporary file which then replaces the settings file, so the
+             *              file on disk always holds either the previous or the new settings.
+             *
+             * @note        The caller must hold the mutex.
+             *
+             * @returns     true if the settings file was written; otherwise false.
+             */
+            auto checkpoint() -> bool;
+
+            /**
+             * @brief       Returns the file name of the write-ahead log.
+             *
+             * @note        The caller must hold the mutex.
+             *
+             * @returns     the file name.
+             */
+            auto logFileName() -> QString;
+
+            /**
+             * @brief       Flushes the data written to a file through to the disk.
+             *
+             * @param[in]   file the open file.
+             *
+             * @returns     true if the data was synced; otherwise false.
+             */
+            static auto syncFile(QFile &file) -> bool;
+
+            /**
+             * @brief       Returns the checksum of a write-ahead log record.
+             *
+             * @param[in]   data the contents of the record.
+             *
+             * @returns     the checksum.
+             */
+            static auto checksum(const QByteArray &data) -> quint32;
+
+        private:
+            //! @cond
+
+            QMutex m_mutex;
+            QString m_fileName;
+            QVariantMap m_values;
+            QVariantMap m_changedValues;
+            QSet<QString> m_removedKeys;
+            qint64 m_logSize;
+            bool m_isLoaded;
+            bool m_isModified;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_SETTINGSSTORE_H
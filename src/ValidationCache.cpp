@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ValidationCache.h"
+
+#include "ConstraintRegistry.h"
+#include "ISettingsPage.h"
+
+#include <QTimer>
+
+constexpr auto ValidationDelay = 250;
+
+Nedrysoft::SettingsDialog::ValidationCache::ValidationCache(QObject *parent) :
+        QObject(parent),
+        m_constraintRegistry(nullptr) {
+
+    m_timer = new QTimer(this);
+
+    m_timer->setSingleShot(true);
+    m_timer->setInterval(ValidationDelay);
+
+    connect(m_timer, &QTimer::timeout, [=]() {
+        validateNextPage();
+    });
+}
+
+auto Nedrysoft::SettingsDialog::ValidationCache::setConstraintRegistry(ConstraintRegistry *registry) -> void {
+    m_constraintRegistry = registry;
+
+    connect(registry, &ConstraintRegistry::pageInvalidated, this, [=](ISettingsPage *page) {
+        invalidate(page);
+    });
+}
+
+auto Nedrysoft::SettingsDialog::ValidationCache::addPage(ISettingsPage *page) -> void {
+    m_pages.insert(page);
+}
+
+auto Nedrysoft::SettingsDialog::ValidationCache::invalidate(ISettingsPage *page) -> void {
+    // the constraints of a page that has not been shown can change, such pages are checked against the registry
+    // when the settings are accepted rather than being validated here.
+
+    if (!m_pages.contains(page)) {
+        return;
+    }
+
+    m_results.remove(page);
+
+    if (!m_pendingPages.contains(page)) {
+        m_pendingPages.append(page);
+    }
+
+    m_timer->start();
+}
+
+auto Nedrysoft::SettingsDialog::ValidationCache::isValid(ISettingsPage *page) -> bool {
+    auto result = m_results.constFind(page);
+
+    if (result!=m_results.constEnd()) {
+        return result.value();
+    }
+
+    m_pendingPages.removeAll(page);
+
+    return validate(page);
+}
+
+auto Nedrysoft::SettingsDialog::ValidationCache::firstInvalidPage(
+        const QList<ISettingsPage *> &pages) -> Nedrysoft::SettingsDialog::ISettingsPage * {
+
+    for (auto page : pages) {
+        if (!isValid(page)) {
+            return page;
+        }
+    }
+
+    return nullptr;
+}
+
+auto Nedrysoft::SettingsDialog::ValidationCache::validate(ISettingsPage *page) -> bool {
+    // the cached result is discarded when the page changes, so the change is detected against the validity that
+    // was last reported rather than the cached result.  A page is assumed to be valid until it is validated.
+
+    auto wasValid = m_reportedValidity.value(page, true);
+    auto isPageValid = page->canAcceptSettings();
+
+    if (isPageValid && m_constraintRegistry) {
+        isPageValid = m_constraintRegistry->isValid(page);
+    }
+
+    m_results[page] = isPageValid;
+    m_reportedValidity[page] = isPageValid;
+
+    if (isPageValid!=wasValid) {
+        Q_EMIT validityChanged(page, isPageValid);
+    }
+
+    return isPageValid;
+}
+
+auto Nedrysoft::SettingsDialog::ValidationCache::validateNextPage() -> void {
+    if (m_pendingPages.isEmpty() || m_timer->isActive()) {
+        return;
+    }
+
+    validate(m_pendingPages.takeFirst());
+
+    // the remaining pages are validated on later event loop iterations, a new change restarts the timer and
+    // pauses validation until the changes stop.
+
+    if (!m_pendingPages.isEmpty()) {
+        QMetaObject::invokeMethod(this, [=]() {
+            validateNextPage();
+        }, Qt::QueuedConnection);
+    }
+}
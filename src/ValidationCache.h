@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft SettingsDialog. (https://github.com/nedrysoft/SettingsDialog)
+ *
+ * A cross-platform settings dialog
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_VALIDATIONCACHE_H
+#define NEDRYSOFT_VALIDATIONCACHE_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QSet>
+
+class QTimer;
+
+namespace Nedrysoft { namespace SettingsDialog {
+    class ConstraintRegistry;
+    class ISettingsPage;
+
+    /**
+     * @brief       The ValidationCache class validates pages ahead of time and caches the results.
+     *
+     * @details     A page is queued for validation when it changes, once no further changes have been made for a
+     *              short time the queued pages are validated one per event loop iteration so that the dialog
+     *              remains responsive.  The result of a page is kept until it changes again, so accepting the
+     *              settings only needs to validate pages whose result is not yet known.
+     *
+     * @note        ISettingsPage::canAcceptSettings() reads the page widget, so validation takes place on the GUI
+     *              thread while the event loop is otherwise idle rather than on a worker thread.
+     */
+    class ValidationCache :
+            public QObject {
+
+        private:
+            Q_OBJECT
+
+        public:
+            /**
+             * @brief       Constructs a new ValidationCache.
+             *
+             * @param[in]   parent the owner of the cache.
+             */
+            explicit ValidationCache(QObject *parent=nullptr);
+
+            /**
+             * @brief       Sets the registry whose constraints a page must also satisfy to be valid.
+             *
+             * @details     Pages are queued for validation when the registry reports that their constraints
+             *              need to be re-evaluated.
+             *
+             * @param[in]   registry the registry.
+             */
+            auto setConstraintRegistry(ConstraintRegistry *registry) -> void;
+
+            /**
+             * @brief       Starts validating a page ahead of time.
+             *
+             * @details     Only pages whose widget has been created are validated ahead of time, as
+             *              ISettingsPage::canAcceptSettings() reads the widget.  Changes to the other pages are
+             *              ignored.
+             *
+             * @param[in]   page the page.
+             */
+            auto addPage(ISettingsPage *page) -> void;
+
+            /**
+             * @brief       Discards the result of a page and queues it for validation.
+             *
+             * @note        Pages that have not been added with addPage() are ignored.
+             *
+             * @param[in]   page the page that has changed.
+             */
+            auto invalidate(ISettingsPage *page) -> void;
+
+            /**
+             * @brief       Returns whether a page is valid.
+             *
+             * @details     The cached result is returned if there is one, otherwise the page is validated
+             *              immediately.
+             *
+             * @param[in]   page the page.
+             *
+             * @returns     true if the settings of the page can be accepted; otherwise false.
+             */
+            auto isValid(ISettingsPage *page) -> bool;
+
+            /**
+             * @brief       Returns the first page in a list that is not valid.
+             *
+             * @param[in]   pages the pages to check.
+             *
+             * @returns     the first invalid page if any; otherwise nullptr.
+             */
+            auto firstInvalidPage(const QList<ISettingsPage *> &pages) -> ISettingsPage *;
+
+            /**
+             * @brief       Emitted when the validity of a page changes.
+             *
+             * @param[in]   page the page.
+             * @param[in]   isValid true if the page is now valid; otherwise false.
+             */
+            Q_SIGNAL void validityChanged(Nedrysoft::SettingsDialog::ISettingsPage *page, bool isValid);
+
+        private:
+            /**
+             * @brief       Validates a page and stores the result.
+             *
+             * @param[in]   page the page.
+             *
+             * @returns     the result.
+             */
+            auto validate(ISettingsPage *page) -> bool;
+
+            /**
+             * @brief       Validates the next queued page.
+             */
+            auto validateNextPage() -> void;
+
+        private:
+            //! @cond
+
+            QTimer *m_timer;
+            ConstraintRegistry *m_constraintRegistry;
+            QSet<ISettingsPage *> m_pages;
+            QList<ISettingsPage *> m_pendingPages;
+            QHash<ISettingsPage *, bool> m_results;
+            QHash<ISettingsPage *, bool> m_reportedValidity;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_VALIDATIONCACHE_H